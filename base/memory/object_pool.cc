@@ -0,0 +1,146 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/object_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+namespace base {
+
+namespace {
+
+constexpr size_t kSlotAlignment = alignof(std::max_align_t);
+constexpr size_t kChunkBytes = 64 * 1024;
+constexpr size_t kMinSlotsPerChunk = 16;
+
+// Precedes every object of pool enabled types, null pool for heap blocks
+struct alignas(kSlotAlignment) SlotHeader {
+  ObjectPool* pool;
+};
+
+thread_local ObjectPoolSet* g_current_pools = nullptr;
+
+}  // namespace
+
+///
+/// ObjectPool
+///
+
+ObjectPool::ObjectPool(size_t slot_size)
+    : slot_size_((std::max(slot_size, sizeof(void*)) + kSlotAlignment - 1) &
+                 ~(kSlotAlignment - 1)),
+      slots_per_chunk_(std::max(kChunkBytes / slot_size_, kMinSlotsPerChunk)),
+      chunk_cursor_(nullptr),
+      chunk_end_(nullptr),
+      free_list_(nullptr),
+      live_count_(0) {}
+
+ObjectPool::~ObjectPool() {
+  for (void* chunk : chunks_)
+    ::operator delete(chunk, std::align_val_t(kSlotAlignment));
+}
+
+void* ObjectPool::Allocate() {
+  ++live_count_;
+
+  if (free_list_) {
+    void* slot = free_list_;
+    free_list_ = *static_cast<void**>(slot);
+    return slot;
+  }
+
+  if (chunk_cursor_ == chunk_end_) {
+    const size_t chunk_bytes = slot_size_ * slots_per_chunk_;
+    chunk_cursor_ = static_cast<char*>(
+        ::operator new(chunk_bytes, std::align_val_t(kSlotAlignment)));
+    chunk_end_ = chunk_cursor_ + chunk_bytes;
+    chunks_.push_back(chunk_cursor_);
+  }
+
+  void* slot = chunk_cursor_;
+  chunk_cursor_ += slot_size_;
+  return slot;
+}
+
+void ObjectPool::Free(void* slot) {
+  *static_cast<void**>(slot) = free_list_;
+  free_list_ = slot;
+  --live_count_;
+}
+
+///
+/// ObjectPoolSet
+///
+
+ObjectPoolSet::ObjectPoolSet() = default;
+
+ObjectPoolSet::~ObjectPoolSet() = default;
+
+ObjectPool* ObjectPoolSet::GetPool(const void* type_key, size_t slot_size) {
+  for (auto& it : pools_)
+    if (it.type_key == type_key && it.slot_size == slot_size)
+      return it.pool.get();
+
+  pools_.push_back(
+      {type_key, slot_size, MakeRefCounted<ObjectPool>(slot_size)});
+  return pools_.back().pool.get();
+}
+
+///
+/// ObjectPoolScope
+///
+
+ObjectPoolScope::ObjectPoolScope(ObjectPoolSet* pools)
+    : previous_(g_current_pools) {
+  g_current_pools = pools;
+}
+
+ObjectPoolScope::~ObjectPoolScope() {
+  g_current_pools = previous_;
+}
+
+// static
+ObjectPoolSet* ObjectPoolScope::Current() {
+  return g_current_pools;
+}
+
+namespace internal {
+
+void* PoolAllocate(const void* type_key, size_t size) {
+  const size_t block_size = sizeof(SlotHeader) + size;
+
+  ObjectPool* pool = nullptr;
+  SlotHeader* header;
+  if (g_current_pools) {
+    pool = g_current_pools->GetPool(type_key, block_size);
+    header = static_cast<SlotHeader*>(pool->Allocate());
+    pool->AddRef();
+  } else {
+    header = static_cast<SlotHeader*>(
+        ::operator new(block_size, std::align_val_t(kSlotAlignment)));
+  }
+
+  header->pool = pool;
+  return header + 1;
+}
+
+void PoolFree(void* ptr) {
+  if (!ptr)
+    return;
+
+  SlotHeader* header = static_cast<SlotHeader*>(ptr) - 1;
+  if (ObjectPool* pool = header->pool) {
+    pool->Free(header);
+    // May destroy the pool after its owner is gone
+    pool->Release();
+  } else {
+    ::operator delete(header, std::align_val_t(kSlotAlignment));
+  }
+}
+
+}  // namespace internal
+
+}  // namespace base
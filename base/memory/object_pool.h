@@ -0,0 +1,122 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+
+namespace base {
+
+///
+/// Fixed size slots carved out of large chunks. Freed slots are reused
+/// through an intrusive free list, chunks are returned all at once when the
+/// pool is destroyed. Every live slot holds a reference of its pool, so the
+/// pool outlives its owner until the last object has been freed.
+/// Pools are not thread safe.
+///
+class ObjectPool : public RefCounted<ObjectPool> {
+ public:
+  explicit ObjectPool(size_t slot_size);
+
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+
+  void* Allocate();
+  void Free(void* slot);
+
+  size_t slot_size() const { return slot_size_; }
+  size_t live_count() const { return live_count_; }
+
+ private:
+  friend class RefCounted<ObjectPool>;
+  ~ObjectPool();
+
+  size_t slot_size_;
+  size_t slots_per_chunk_;
+
+  std::vector<void*> chunks_;
+  char* chunk_cursor_;
+  char* chunk_end_;
+  void* free_list_;
+  size_t live_count_;
+};
+
+///
+/// Pools of one owner, segregated by type and size.
+///
+class ObjectPoolSet : public RefCounted<ObjectPoolSet> {
+ public:
+  ObjectPoolSet();
+
+  ObjectPoolSet(const ObjectPoolSet&) = delete;
+  ObjectPoolSet& operator=(const ObjectPoolSet&) = delete;
+
+  ObjectPool* GetPool(const void* type_key, size_t slot_size);
+
+ private:
+  friend class RefCounted<ObjectPoolSet>;
+  ~ObjectPoolSet();
+
+  struct Entry {
+    const void* type_key;
+    size_t slot_size;
+    scoped_refptr<ObjectPool> pool;
+  };
+
+  // Few types per owner, linear lookup
+  std::vector<Entry> pools_;
+};
+
+///
+/// Routes allocations of pool enabled types on the current thread to
+/// |pools| while the scope is alive, scopes may be nested.
+///
+class ObjectPoolScope {
+ public:
+  explicit ObjectPoolScope(ObjectPoolSet* pools);
+  ~ObjectPoolScope();
+
+  ObjectPoolScope(const ObjectPoolScope&) = delete;
+  ObjectPoolScope& operator=(const ObjectPoolScope&) = delete;
+
+  // Pools of the innermost scope, null if none.
+  static ObjectPoolSet* Current();
+
+ private:
+  ObjectPoolSet* previous_;
+};
+
+namespace internal {
+
+template <typename T>
+struct PoolTypeKey {
+  static constexpr char kKey = 0;
+};
+
+void* PoolAllocate(const void* type_key, size_t size);
+void PoolFree(void* ptr);
+
+}  // namespace internal
+
+}  // namespace base
+
+// Enables pooled allocation of a class. Instances created inside an
+// ObjectPoolScope come from its pools, others from the heap. Derived classes
+// not declaring this themselves are pooled by their own size.
+#define BASE_POOL_ALLOCATED(Type)                                         \
+ public:                                                                  \
+  static void* operator new(size_t size) {                                \
+    return ::base::internal::PoolAllocate(                                \
+        &::base::internal::PoolTypeKey<Type>::kKey, size);                \
+  }                                                                       \
+  static void operator delete(void* ptr) {                                \
+    ::base::internal::PoolFree(ptr);                                      \
+  }                                                                       \
+                                                                          \
+ private:                                                                 \
+  static_assert(true, "")
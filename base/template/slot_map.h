@@ -0,0 +1,109 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "base/template/vector_util.h"
+
+namespace base {
+
+///
+/// Dense storage addressed through stable handles. Values are kept
+/// contiguous for linear iteration, removal moves the last value into the
+/// freed position so insertion and removal are both O(1). Iteration order is
+/// not preserved across removals.
+///
+template <typename T>
+class SlotMap {
+ public:
+  using Handle = uint32_t;
+  static constexpr Handle kInvalidHandle = std::numeric_limits<Handle>::max();
+
+  SlotMap() = default;
+
+  SlotMap(const SlotMap&) = delete;
+  SlotMap& operator=(const SlotMap&) = delete;
+
+  Handle Insert(T value) {
+    Handle handle;
+    if (!free_handles_.empty()) {
+      handle = free_handles_.back();
+      free_handles_.pop_back();
+    } else {
+      handle = static_cast<Handle>(dense_indices_.size());
+      dense_indices_.push_back(kInvalidHandle);
+    }
+
+    dense_indices_[handle] = static_cast<uint32_t>(values_.size());
+    values_.push_back(std::move(value));
+    handles_.push_back(handle);
+
+    return handle;
+  }
+
+  void Remove(Handle handle) {
+    const uint32_t index = dense_indices_[handle];
+    const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+
+    if (index != last) {
+      values_[index] = std::move(values_[last]);
+      handles_[index] = handles_[last];
+      dense_indices_[handles_[index]] = index;
+    }
+
+    values_.pop_back();
+    handles_.pop_back();
+
+    dense_indices_[handle] = kInvalidHandle;
+    free_handles_.push_back(handle);
+  }
+
+  // Preallocates storage of |count| further insertions.
+  void Reserve(size_t count) {
+    ReserveAdditional(values_, count);
+    ReserveAdditional(handles_, count);
+    if (count > free_handles_.size())
+      ReserveAdditional(dense_indices_, count - free_handles_.size());
+  }
+
+  bool Contains(Handle handle) const {
+    return handle < dense_indices_.size() &&
+           dense_indices_[handle] != kInvalidHandle;
+  }
+
+  T& operator[](Handle handle) { return values_[dense_indices_[handle]]; }
+  const T& operator[](Handle handle) const {
+    return values_[dense_indices_[handle]];
+  }
+
+  // Dense access
+  T* data() { return values_.data(); }
+  const T* data() const { return values_.data(); }
+  size_t size() const { return values_.size(); }
+  Handle handle_at(size_t index) const { return handles_[index]; }
+  bool empty() const { return values_.empty(); }
+
+  typename std::vector<T>::iterator begin() { return values_.begin(); }
+  typename std::vector<T>::iterator end() { return values_.end(); }
+  typename std::vector<T>::const_iterator begin() const {
+    return values_.begin();
+  }
+  typename std::vector<T>::const_iterator end() const { return values_.end(); }
+
+ private:
+  // Dense values and their owning handles
+  std::vector<T> values_;
+  std::vector<Handle> handles_;
+
+  // Handle to dense index
+  std::vector<uint32_t> dense_indices_;
+  std::vector<Handle> free_handles_;
+};
+
+}  // namespace base
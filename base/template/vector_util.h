@@ -0,0 +1,25 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace base {
+
+///
+/// Reserves room for |count| more elements past the current size. Capacity
+/// grows at least geometrically so repeated small reservations stay
+/// amortized O(1) per element.
+///
+template <typename T>
+void ReserveAdditional(std::vector<T>& storage, size_t count) {
+  const size_t required = storage.size() + count;
+  if (required > storage.capacity())
+    storage.reserve(std::max(required, storage.capacity() * 2));
+}
+
+}  // namespace base
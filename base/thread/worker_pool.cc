@@ -0,0 +1,130 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/thread/worker_pool.h"
+
+namespace base {
+
+namespace {
+
+size_t g_default_concurrency = 0;
+
+}  // namespace
+
+thread_local bool WorkerPool::in_worker_job_ = false;
+
+WorkerPool::WorkerPool(size_t concurrency)
+    : generation_(0),
+      active_workers_(0),
+      quit_(false),
+      context_(nullptr),
+      function_(nullptr),
+      chunk_count_(0),
+      next_chunk_(0),
+      pending_(0) {
+  if (!concurrency)
+    concurrency = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+  workers_.reserve(concurrency - 1);
+  for (size_t i = 1; i < concurrency; ++i)
+    workers_.emplace_back(&WorkerPool::WorkerMain, this);
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = true;
+  }
+
+  wake_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+// static
+WorkerPool* WorkerPool::GetDefault() {
+  static WorkerPool instance(g_default_concurrency);
+  return &instance;
+}
+
+// static
+void WorkerPool::SetDefaultConcurrency(size_t concurrency) {
+  g_default_concurrency = concurrency;
+}
+
+void WorkerPool::Dispatch(size_t chunks,
+                          void* context,
+                          ChunkFunction function) {
+  std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+
+  {
+    // Stragglers of the previous job must leave before it is replaced
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return active_workers_ == 0; });
+
+    context_ = context;
+    function_ = function;
+    chunk_count_ = chunks;
+    next_chunk_.store(0, std::memory_order_relaxed);
+    pending_.store(chunks, std::memory_order_relaxed);
+    ++generation_;
+  }
+
+  wake_.notify_all();
+  RunChunks();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] {
+    return pending_.load(std::memory_order_acquire) == 0 &&
+           active_workers_ == 0;
+  });
+}
+
+void WorkerPool::RunChunks() {
+  const bool outer_job = in_worker_job_;
+  in_worker_job_ = true;
+
+  for (;;) {
+    const size_t chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+    if (chunk >= chunk_count_)
+      break;
+
+    function_(context_, chunk);
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_.notify_all();
+    }
+  }
+
+  in_worker_job_ = outer_job;
+}
+
+void WorkerPool::WorkerMain() {
+  uint64_t seen_generation = 0;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock,
+                 [&] { return quit_ || generation_ != seen_generation; });
+      if (quit_)
+        return;
+
+      seen_generation = generation_;
+      if (pending_.load(std::memory_order_acquire) == 0)
+        continue;
+      ++active_workers_;
+    }
+
+    RunChunks();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --active_workers_;
+    }
+    done_.notify_all();
+  }
+}
+
+}  // namespace base
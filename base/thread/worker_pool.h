@@ -0,0 +1,97 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace base {
+
+///
+/// Fixed-size pool of worker threads for data-parallel jobs. ParallelFor
+/// splits an index range into chunks, the calling thread takes part in the
+/// work and returns once every chunk has been processed. Calls from inside a
+/// running job are executed inline on the calling worker.
+///
+class WorkerPool {
+ public:
+  // Runs jobs on |concurrency| threads, the calling thread included. Zero
+  // picks the hardware concurrency.
+  explicit WorkerPool(size_t concurrency = 0);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Shared pool used by engine stages.
+  static WorkerPool* GetDefault();
+
+  // Concurrency of the shared pool, only effective before its first use.
+  static void SetDefaultConcurrency(size_t concurrency);
+
+  // Workers plus the calling thread.
+  size_t concurrency() const { return workers_.size() + 1; }
+
+  // Invokes |job(begin, end)| over [0, count) in chunks of at least |grain|.
+  template <typename Functor>
+  void ParallelFor(size_t count, size_t grain, Functor&& job) {
+    if (!count)
+      return;
+
+    grain = grain ? grain : 1;
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks <= 1 || workers_.empty() || in_worker_job_) {
+      job(size_t(0), count);
+      return;
+    }
+
+    struct Context {
+      Functor* job;
+      size_t count;
+      size_t grain;
+    } context{&job, count, grain};
+
+    Dispatch(chunks, &context, [](void* ctx, size_t chunk) {
+      auto* context = static_cast<Context*>(ctx);
+      const size_t begin = chunk * context->grain;
+      const size_t end = std::min(begin + context->grain, context->count);
+      (*context->job)(begin, end);
+    });
+  }
+
+ private:
+  using ChunkFunction = void (*)(void* context, size_t chunk);
+
+  void Dispatch(size_t chunks, void* context, ChunkFunction function);
+  void RunChunks();
+  void WorkerMain();
+
+  std::vector<std::thread> workers_;
+
+  // Serializes jobs submitted from different threads
+  std::mutex dispatch_mutex_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  uint64_t generation_;
+  size_t active_workers_;
+  bool quit_;
+
+  // Current job, valid while |pending_| is non-zero
+  void* context_;
+  ChunkFunction function_;
+  size_t chunk_count_;
+  std::atomic<size_t> next_chunk_;
+  std::atomic<size_t> pending_;
+
+  static thread_local bool in_worker_job_;
+};
+
+}  // namespace base
@@ -6,6 +6,7 @@
 
 #include <map>
 
+#include "base/thread/worker_pool.h"
 #include "content/profile/core_profile.h"
 #include "content/render/graphics.h"
 
@@ -35,6 +36,9 @@ Runner::~Runner() {
 ExternalBinding::Result Runner::AppInit() {
   auto* core_profile = CoreProfile::Instance();
 
+  // Threads of the culling and transform jobs, zero for all hardware threads
+  base::WorkerPool::SetDefaultConcurrency(core_profile->core.threads);
+
   // Main window
   ui::Widget::InitParams window_params;
   window_params.size = core_profile->window.size;
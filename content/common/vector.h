@@ -8,6 +8,7 @@
 #include "glm/vec3.hpp"
 #include "glm/vec4.hpp"
 
+#include "base/memory/object_pool.h"
 #include "content/common/exception.h"
 #include "content/common/object.h"
 #include "content/content_config.h"
@@ -407,6 +408,8 @@ class Vector3 : public Constant {
 // ================= Vector3d (double) =================
 URGE_BINDING()
 class Vector3d : public Constant {
+  BASE_POOL_ALLOCATED(Vector3d);
+
  public:
   Vector3d() : data_() {}
   Vector3d(double x, double y, double z) : data_(x, y, z) {}
@@ -77,7 +77,7 @@ void GPUComputePassEncoder::End(URGE_EXCEPTION) {
 ///
 
 GPURenderPassEncoder::GPURenderPassEncoder(wgpu::RenderPassEncoder object)
-    : object_(object) {}
+    : object_(object), state_(object) {}
 
 void GPURenderPassEncoder::SetLabel(estring label, URGE_EXCEPTION) {
   object_.SetLabel(std::string_view(label));
@@ -141,8 +141,8 @@ void GPURenderPassEncoder::SetBindGroup(uint32_t group_index,
                                         scoped_refptr<GPUBindGroup> group,
                                         earray<uint32_t> dynamic_offsets,
                                         URGE_EXCEPTION) {
-  object_.SetBindGroup(group_index, WGPU_PTR(group), dynamic_offsets.size(),
-                       dynamic_offsets.data());
+  state_.SetBindGroup(group_index, WGPU_PTR(group), dynamic_offsets.size(),
+                      dynamic_offsets.data());
 }
 
 void GPURenderPassEncoder::SetBlendConstant(scoped_refptr<GPUColor> color,
@@ -158,8 +158,8 @@ void GPURenderPassEncoder::SetIndexBuffer(scoped_refptr<GPUBuffer> buffer,
                                           uint64_t offset,
                                           uint64_t size,
                                           URGE_EXCEPTION) {
-  object_.SetIndexBuffer(WGPU_PTR(buffer),
-                         static_cast<wgpu::IndexFormat>(format), offset, size);
+  state_.SetIndexBuffer(WGPU_PTR(buffer),
+                        static_cast<wgpu::IndexFormat>(format), offset, size);
 }
 
 void GPURenderPassEncoder::SetImmediates(uint32_t offset,
@@ -172,7 +172,7 @@ void GPURenderPassEncoder::SetImmediates(uint32_t offset,
 void GPURenderPassEncoder::SetPipeline(
     scoped_refptr<GPURenderPipeline> pipeline,
     URGE_EXCEPTION) {
-  object_.SetPipeline(WGPU_PTR(pipeline));
+  state_.SetPipeline(WGPU_PTR(pipeline));
 }
 
 void GPURenderPassEncoder::SetScissorRect(uint32_t x,
@@ -185,7 +185,7 @@ void GPURenderPassEncoder::SetScissorRect(uint32_t x,
 
 void GPURenderPassEncoder::SetStencilReference(uint32_t reference,
                                                URGE_EXCEPTION) {
-  object_.SetStencilReference(reference);
+  state_.SetStencilReference(reference);
 }
 
 void GPURenderPassEncoder::SetVertexBuffer(uint32_t slot,
@@ -193,7 +193,7 @@ void GPURenderPassEncoder::SetVertexBuffer(uint32_t slot,
                                            uint64_t offset,
                                            uint64_t size,
                                            URGE_EXCEPTION) {
-  object_.SetVertexBuffer(slot, WGPU_PTR(buffer), offset, size);
+  state_.SetVertexBuffer(slot, WGPU_PTR(buffer), offset, size);
 }
 
 void GPURenderPassEncoder::SetViewport(float x,
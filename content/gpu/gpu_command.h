@@ -9,6 +9,7 @@
 #include "content/common/object.h"
 #include "content/content_config.h"
 #include "content/gpu/gpu_resource.h"
+#include "content/gpu/render_pass_state.h"
 
 namespace content {
 
@@ -86,6 +87,10 @@ class GPURenderPassEncoder : public Object {
 
   wgpu::RenderPassEncoder handle() const { return object_; }
 
+  // Pipeline, bind group, buffer and stencil reference changes go through
+  // the tracked state, natively encoded draws included.
+  RenderPassState* state() { return &state_; }
+
  public:
   URGE_BINDING()
   void SetLabel(estring label, URGE_EXCEPTION);
@@ -186,6 +191,7 @@ class GPURenderPassEncoder : public Object {
 
  private:
   wgpu::RenderPassEncoder object_;
+  RenderPassState state_;
 };
 
 ///
@@ -306,7 +306,8 @@ scoped_refptr<GPUPipelineLayout> GPUDevice::CreatePipelineLayout(
   auto result = object_.CreatePipelineLayout(&create_desc);
   if (!result)
     return nullptr;
-  return Object::Create<GPUPipelineLayout>(result);
+  return Object::Create<GPUPipelineLayout>(
+      result, descriptor ? descriptor->immediateSize : 0);
 }
 
 scoped_refptr<GPUQuerySet> GPUDevice::CreateQuerySet(
@@ -484,7 +485,10 @@ scoped_refptr<GPURenderPipeline> GPUDevice::CreateRenderPipeline(
   auto result = object_.CreateRenderPipeline(&create_desc);
   if (!result)
     return nullptr;
-  return Object::Create<GPURenderPipeline>(result);
+  const uint32_t immediate_size =
+      descriptor && descriptor->layout ? descriptor->layout->immediate_size()
+                                       : 0;
+  return Object::Create<GPURenderPipeline>(result, immediate_size);
 }
 
 uint64_t GPUDevice::CreateRenderPipelineAsync(
@@ -647,13 +651,20 @@ uint64_t GPUDevice::CreateRenderPipelineAsync(
   WGPUCreateRenderPipelineAsyncCallbackInfo callback_info = {};
   callback_info.userdata1 =
       new CreateRenderPipelineAsyncCallback(std::move(callback));
+  // Immediate size of the layout travels by value
+  callback_info.userdata2 = reinterpret_cast<void*>(static_cast<uintptr_t>(
+      descriptor && descriptor->layout ? descriptor->layout->immediate_size()
+                                       : 0));
   callback_info.callback = [](WGPUCreatePipelineAsyncStatus status,
                               WGPURenderPipeline pipeline,
                               WGPUStringView message, void* userdata1,
                               void* userdata2) {
     auto* callback = static_cast<CreateRenderPipelineAsyncCallback*>(userdata1);
+    const uint32_t immediate_size =
+        static_cast<uint32_t>(reinterpret_cast<uintptr_t>(userdata2));
     auto wrapped_pipeline =
-        pipeline ? Object::Create<GPURenderPipeline>(pipeline) : nullptr;
+        pipeline ? Object::Create<GPURenderPipeline>(pipeline, immediate_size)
+                 : nullptr;
     callback->Run(static_cast<GPU::CreatePipelineAsyncStatus>(status),
                   wrapped_pipeline, std::string(message.data, message.length));
     delete callback;
@@ -209,8 +209,9 @@ void GPUBindGroupLayout::SetLabel(estring label, URGE_EXCEPTION) {
 /// GPU PipelineLayout
 ///
 
-GPUPipelineLayout::GPUPipelineLayout(wgpu::PipelineLayout object)
-    : object_(object) {}
+GPUPipelineLayout::GPUPipelineLayout(wgpu::PipelineLayout object,
+                                     uint32_t immediate_size)
+    : object_(object), immediate_size_(immediate_size) {}
 
 void GPUPipelineLayout::SetLabel(estring label, URGE_EXCEPTION) {
   object_.SetLabel(std::string_view(label));
@@ -220,8 +221,9 @@ void GPUPipelineLayout::SetLabel(estring label, URGE_EXCEPTION) {
 /// GPU RenderPipeline
 ///
 
-GPURenderPipeline::GPURenderPipeline(wgpu::RenderPipeline object)
-    : object_(object) {}
+GPURenderPipeline::GPURenderPipeline(wgpu::RenderPipeline object,
+                                     uint32_t immediate_size)
+    : object_(object), immediate_size_(immediate_size) {}
 
 void GPURenderPipeline::SetLabel(estring label, URGE_EXCEPTION) {
   object_.SetLabel(std::string_view(label));
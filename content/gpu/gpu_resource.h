@@ -258,19 +258,23 @@ class GPUBindGroupLayout : public Object {
 URGE_BINDING()
 class GPUPipelineLayout : public Object {
  public:
-  GPUPipelineLayout(wgpu::PipelineLayout object);
+  GPUPipelineLayout(wgpu::PipelineLayout object, uint32_t immediate_size);
 
   GPUPipelineLayout(const GPUPipelineLayout&) = delete;
   GPUPipelineLayout& operator=(const GPUPipelineLayout&) = delete;
 
   wgpu::PipelineLayout handle() const { return object_; }
 
+  // Bytes of immediate data declared by the layout.
+  uint32_t immediate_size() const { return immediate_size_; }
+
  public:
   URGE_BINDING()
   void SetLabel(estring label, URGE_EXCEPTION);
 
  private:
   wgpu::PipelineLayout object_;
+  uint32_t immediate_size_;
 };
 
 ///
@@ -280,13 +284,17 @@ class GPUPipelineLayout : public Object {
 URGE_BINDING()
 class GPURenderPipeline : public Object {
  public:
-  GPURenderPipeline(wgpu::RenderPipeline object);
+  GPURenderPipeline(wgpu::RenderPipeline object, uint32_t immediate_size);
 
   GPURenderPipeline(const GPURenderPipeline&) = delete;
   GPURenderPipeline& operator=(const GPURenderPipeline&) = delete;
 
   wgpu::RenderPipeline handle() const { return object_; }
 
+  // Bytes of immediate data declared by the explicit layout of the pipeline,
+  // zero for automatic layouts.
+  uint32_t immediate_size() const { return immediate_size_; }
+
  public:
   URGE_BINDING()
   void SetLabel(estring label, URGE_EXCEPTION);
@@ -297,6 +305,7 @@ class GPURenderPipeline : public Object {
 
  private:
   wgpu::RenderPipeline object_;
+  uint32_t immediate_size_;
 };
 
 ///
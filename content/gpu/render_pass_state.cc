@@ -0,0 +1,95 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/gpu/render_pass_state.h"
+
+#include <algorithm>
+
+namespace content {
+
+RenderPassState::RenderPassState(wgpu::RenderPassEncoder encoder)
+    : encoder_(encoder),
+      index_format_(wgpu::IndexFormat::Undefined),
+      issued_count_(0),
+      skipped_count_(0) {}
+
+RenderPassState::~RenderPassState() = default;
+
+void RenderPassState::SetPipeline(const wgpu::RenderPipeline& pipeline) {
+  if (!Track(!pipeline_ || pipeline_->Get() != pipeline.Get()))
+    return;
+
+  pipeline_ = pipeline;
+  encoder_.SetPipeline(pipeline);
+}
+
+void RenderPassState::SetBindGroup(uint32_t group_index,
+                                   const wgpu::BindGroup& group,
+                                   size_t dynamic_offset_count,
+                                   const uint32_t* dynamic_offsets) {
+  if (group_index >= bind_groups_.size())
+    bind_groups_.resize(group_index + 1);
+
+  auto& bound = bind_groups_[group_index];
+  const bool changed =
+      !bound || bound->group.Get() != group.Get() ||
+      !std::equal(bound->dynamic_offsets.begin(), bound->dynamic_offsets.end(),
+                  dynamic_offsets, dynamic_offsets + dynamic_offset_count);
+  if (!Track(changed))
+    return;
+
+  bound = BindGroupState{
+      group, std::vector<uint32_t>(dynamic_offsets,
+                                   dynamic_offsets + dynamic_offset_count)};
+  encoder_.SetBindGroup(group_index, group, dynamic_offset_count,
+                        dynamic_offsets);
+}
+
+void RenderPassState::SetVertexBuffer(uint32_t slot,
+                                      const wgpu::Buffer& buffer,
+                                      uint64_t offset,
+                                      uint64_t size) {
+  if (slot >= vertex_buffers_.size())
+    vertex_buffers_.resize(slot + 1);
+
+  auto& bound = vertex_buffers_[slot];
+  if (!Track(!bound || bound->buffer.Get() != buffer.Get() ||
+             bound->offset != offset || bound->size != size))
+    return;
+
+  bound = BufferState{buffer, offset, size};
+  encoder_.SetVertexBuffer(slot, buffer, offset, size);
+}
+
+void RenderPassState::SetIndexBuffer(const wgpu::Buffer& buffer,
+                                     wgpu::IndexFormat format,
+                                     uint64_t offset,
+                                     uint64_t size) {
+  if (!Track(!index_buffer_ || index_buffer_->buffer.Get() != buffer.Get() ||
+             index_format_ != format || index_buffer_->offset != offset ||
+             index_buffer_->size != size))
+    return;
+
+  index_buffer_ = BufferState{buffer, offset, size};
+  index_format_ = format;
+  encoder_.SetIndexBuffer(buffer, format, offset, size);
+}
+
+void RenderPassState::SetStencilReference(uint32_t reference) {
+  if (!Track(!stencil_reference_ || *stencil_reference_ != reference))
+    return;
+
+  stencil_reference_ = reference;
+  encoder_.SetStencilReference(reference);
+}
+
+bool RenderPassState::Track(bool changed) {
+  if (changed)
+    ++issued_count_;
+  else
+    ++skipped_count_;
+  return changed;
+}
+
+}  // namespace content
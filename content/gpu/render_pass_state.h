@@ -0,0 +1,72 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "webgpu/webgpu_cpp.hpp"
+
+namespace content {
+
+// State bound on a render pass encoder. Calls setting state equal to the
+// bound state are dropped before reaching wgpu, issued and skipped calls are
+// counted. Handles are kept referenced so compared objects stay alive.
+class RenderPassState {
+ public:
+  explicit RenderPassState(wgpu::RenderPassEncoder encoder);
+  ~RenderPassState();
+
+  RenderPassState(const RenderPassState&) = delete;
+  RenderPassState& operator=(const RenderPassState&) = delete;
+
+  void SetPipeline(const wgpu::RenderPipeline& pipeline);
+  void SetBindGroup(uint32_t group_index,
+                    const wgpu::BindGroup& group,
+                    size_t dynamic_offset_count,
+                    const uint32_t* dynamic_offsets);
+  void SetVertexBuffer(uint32_t slot,
+                       const wgpu::Buffer& buffer,
+                       uint64_t offset,
+                       uint64_t size);
+  void SetIndexBuffer(const wgpu::Buffer& buffer,
+                      wgpu::IndexFormat format,
+                      uint64_t offset,
+                      uint64_t size);
+  void SetStencilReference(uint32_t reference);
+
+  uint64_t issued_count() const { return issued_count_; }
+  uint64_t skipped_count() const { return skipped_count_; }
+
+ private:
+  struct BindGroupState {
+    wgpu::BindGroup group;
+    std::vector<uint32_t> dynamic_offsets;
+  };
+
+  struct BufferState {
+    wgpu::Buffer buffer;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  // Counts the call, true if it has to be issued
+  bool Track(bool changed);
+
+  wgpu::RenderPassEncoder encoder_;
+
+  // Unset until first bound in this pass
+  std::optional<wgpu::RenderPipeline> pipeline_;
+  std::vector<std::optional<BindGroupState>> bind_groups_;
+  std::vector<std::optional<BufferState>> vertex_buffers_;
+  std::optional<BufferState> index_buffer_;
+  wgpu::IndexFormat index_format_;
+  std::optional<uint32_t> stencil_reference_;
+
+  uint64_t issued_count_;
+  uint64_t skipped_count_;
+};
+
+}  // namespace content
@@ -28,6 +28,7 @@ CoreProfile::CoreProfile(SDL_IOStream* config_file) {
   {
     core.api_version = core_node["apiVersion"].as<uint32_t>(core.api_version);
     core.scripts = core_node["scripts"].as<std::string>(core.scripts);
+    core.threads = core_node["threads"].as<uint32_t>(core.threads);
   }
 
   auto window_node = root_node["window"];
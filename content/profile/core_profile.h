@@ -24,6 +24,7 @@ class CoreProfile : public Singleton<CoreProfile> {
   struct {
     uint32_t api_version = 0;
     std::string scripts = "Data/Scripts.rxdata";
+    uint32_t threads = 0;
   } core;
 
   struct {
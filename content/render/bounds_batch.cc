@@ -0,0 +1,265 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/render/bounds_batch.h"
+
+#include <cmath>
+
+#include "content/render/simd.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__AVX2__) || defined(__GNUC__) || defined(__clang__))
+#define URGE_CULL_AVX2 1
+#include <immintrin.h>
+#if defined(__AVX2__)
+#define URGE_TARGET_AVX2
+#else
+#define URGE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace content {
+
+namespace {
+
+// Plane coefficients broadcast once per cull
+struct PlaneSet {
+  float normal[Frustum::Count][3];
+  float abs_normal[Frustum::Count][3];
+  float distance[Frustum::Count];
+};
+
+PlaneSet MakePlaneSet(const Frustum& frustum) {
+  PlaneSet planes;
+  for (int32_t i = 0; i < Frustum::Count; ++i) {
+    const Plane& plane =
+        frustum.GetPlane(static_cast<Frustum::PlaneIndex>(i));
+    for (int32_t c = 0; c < 3; ++c) {
+      planes.normal[i][c] = plane.normal[c];
+      planes.abs_normal[i][c] = std::abs(plane.normal[c]);
+    }
+    planes.distance[i] = plane.distance;
+  }
+
+  return planes;
+}
+
+struct BoundsArrays {
+  const float* center_x;
+  const float* center_y;
+  const float* center_z;
+  const float* extent_x;
+  const float* extent_y;
+  const float* extent_z;
+};
+
+// A box is outside once its center is farther behind a plane than its
+// projected radius: dot(n, c) + d + dot(|n|, e) < 0
+size_t CullScalar(const PlaneSet* frustums,
+                  uint32_t frustum_count,
+                  const BoundsArrays& bounds,
+                  size_t begin,
+                  size_t end,
+                  uint32_t* visibility) {
+  for (size_t i = begin; i < end; ++i) {
+    uint32_t mask = 0;
+    for (uint32_t f = 0; f < frustum_count; ++f) {
+      const PlaneSet& planes = frustums[f];
+      bool inside = true;
+      for (int32_t p = 0; p < Frustum::Count && inside; ++p) {
+        const float distance = planes.normal[p][0] * bounds.center_x[i] +
+                               planes.normal[p][1] * bounds.center_y[i] +
+                               planes.normal[p][2] * bounds.center_z[i] +
+                               planes.distance[p];
+        const float radius = planes.abs_normal[p][0] * bounds.extent_x[i] +
+                             planes.abs_normal[p][1] * bounds.extent_y[i] +
+                             planes.abs_normal[p][2] * bounds.extent_z[i];
+        inside = distance + radius >= 0.0f;
+      }
+      mask |= uint32_t(inside) << f;
+    }
+    visibility[i - begin] = mask;
+  }
+
+  return end;
+}
+
+size_t CullFloat4(const PlaneSet* frustums,
+                  uint32_t frustum_count,
+                  const BoundsArrays& bounds,
+                  size_t begin,
+                  size_t end,
+                  uint32_t* visibility) {
+  const simd::Float4 zero = simd::Set1(0.0f);
+
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    const simd::Float4 cx = simd::Load(bounds.center_x + i);
+    const simd::Float4 cy = simd::Load(bounds.center_y + i);
+    const simd::Float4 cz = simd::Load(bounds.center_z + i);
+    const simd::Float4 ex = simd::Load(bounds.extent_x + i);
+    const simd::Float4 ey = simd::Load(bounds.extent_y + i);
+    const simd::Float4 ez = simd::Load(bounds.extent_z + i);
+
+    uint32_t* masks = visibility + (i - begin);
+    for (int32_t lane = 0; lane < 4; ++lane)
+      masks[lane] = 0;
+
+    for (uint32_t f = 0; f < frustum_count; ++f) {
+      const PlaneSet& planes = frustums[f];
+      simd::Float4 inside = simd::CmpGe(zero, zero);
+      for (int32_t p = 0; p < Frustum::Count; ++p) {
+        const simd::Float4 distance =
+            simd::Set1(planes.normal[p][0]) * cx +
+            simd::Set1(planes.normal[p][1]) * cy +
+            simd::Set1(planes.normal[p][2]) * cz +
+            simd::Set1(planes.distance[p]);
+        const simd::Float4 radius =
+            simd::Set1(planes.abs_normal[p][0]) * ex +
+            simd::Set1(planes.abs_normal[p][1]) * ey +
+            simd::Set1(planes.abs_normal[p][2]) * ez;
+        inside = inside & simd::CmpGe(distance + radius, zero);
+      }
+
+      const uint32_t lanes = simd::MoveMask(inside);
+      for (int32_t lane = 0; lane < 4; ++lane)
+        masks[lane] |= ((lanes >> lane) & 1) << f;
+    }
+  }
+
+  return i;
+}
+
+#if defined(URGE_CULL_AVX2)
+
+URGE_TARGET_AVX2 size_t CullAVX2(const PlaneSet* frustums,
+                                 uint32_t frustum_count,
+                                 const BoundsArrays& bounds,
+                                 size_t begin,
+                                 size_t end,
+                                 uint32_t* visibility) {
+  const __m256 zero = _mm256_setzero_ps();
+
+  size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    const __m256 cx = _mm256_loadu_ps(bounds.center_x + i);
+    const __m256 cy = _mm256_loadu_ps(bounds.center_y + i);
+    const __m256 cz = _mm256_loadu_ps(bounds.center_z + i);
+    const __m256 ex = _mm256_loadu_ps(bounds.extent_x + i);
+    const __m256 ey = _mm256_loadu_ps(bounds.extent_y + i);
+    const __m256 ez = _mm256_loadu_ps(bounds.extent_z + i);
+
+    uint32_t* masks = visibility + (i - begin);
+    for (int32_t lane = 0; lane < 8; ++lane)
+      masks[lane] = 0;
+
+    for (uint32_t f = 0; f < frustum_count; ++f) {
+      const PlaneSet& planes = frustums[f];
+      __m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+      for (int32_t p = 0; p < Frustum::Count; ++p) {
+        __m256 distance = _mm256_set1_ps(planes.distance[p]);
+        distance = _mm256_add_ps(
+            distance, _mm256_mul_ps(_mm256_set1_ps(planes.normal[p][0]), cx));
+        distance = _mm256_add_ps(
+            distance, _mm256_mul_ps(_mm256_set1_ps(planes.normal[p][1]), cy));
+        distance = _mm256_add_ps(
+            distance, _mm256_mul_ps(_mm256_set1_ps(planes.normal[p][2]), cz));
+
+        __m256 radius =
+            _mm256_mul_ps(_mm256_set1_ps(planes.abs_normal[p][0]), ex);
+        radius = _mm256_add_ps(
+            radius, _mm256_mul_ps(_mm256_set1_ps(planes.abs_normal[p][1]), ey));
+        radius = _mm256_add_ps(
+            radius, _mm256_mul_ps(_mm256_set1_ps(planes.abs_normal[p][2]), ez));
+
+        inside = _mm256_and_ps(
+            inside,
+            _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+      }
+
+      const uint32_t lanes = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+      for (int32_t lane = 0; lane < 8; ++lane)
+        masks[lane] |= ((lanes >> lane) & 1) << f;
+    }
+  }
+
+  return i;
+}
+
+bool HasAVX2() {
+#if defined(__AVX2__)
+  return true;
+#else
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+#endif
+}
+
+#endif  // defined(URGE_CULL_AVX2)
+
+}  // namespace
+
+BoundsBatch::BoundsBatch() = default;
+
+BoundsBatch::~BoundsBatch() = default;
+
+void BoundsBatch::Resize(size_t count) {
+  center_x_.resize(count);
+  center_y_.resize(count);
+  center_z_.resize(count);
+  extent_x_.resize(count);
+  extent_y_.resize(count);
+  extent_z_.resize(count);
+}
+
+void BoundsBatch::Set(size_t index,
+                      const glm::vec3& bounds_min,
+                      const glm::vec3& bounds_max,
+                      const glm::mat4& model) {
+  const glm::vec3 local_center = (bounds_min + bounds_max) * 0.5f;
+  const glm::vec3 local_extent = (bounds_max - bounds_min) * 0.5f;
+
+  const glm::vec3 center(model * glm::vec4(local_center, 1.0f));
+  const glm::vec3 extent =
+      glm::abs(glm::vec3(model[0])) * local_extent.x +
+      glm::abs(glm::vec3(model[1])) * local_extent.y +
+      glm::abs(glm::vec3(model[2])) * local_extent.z;
+
+  center_x_[index] = center.x;
+  center_y_[index] = center.y;
+  center_z_[index] = center.z;
+  extent_x_[index] = extent.x;
+  extent_y_[index] = extent.y;
+  extent_z_[index] = extent.z;
+}
+
+void BoundsBatch::Cull(const Frustum* frustums,
+                       uint32_t frustum_count,
+                       size_t begin,
+                       size_t end,
+                       uint32_t* visibility) const {
+  PlaneSet planes[kMaxFrustums];
+  for (uint32_t i = 0; i < frustum_count; ++i)
+    planes[i] = MakePlaneSet(frustums[i]);
+
+  const BoundsArrays bounds = {center_x_.data(), center_y_.data(),
+                               center_z_.data(), extent_x_.data(),
+                               extent_y_.data(), extent_z_.data()};
+
+  size_t next = begin;
+#if defined(URGE_CULL_AVX2)
+  if (HasAVX2())
+    next = CullAVX2(planes, frustum_count, bounds, next, end, visibility);
+#endif
+
+#if defined(URGE_SIMD_SSE2) || defined(URGE_SIMD_NEON)
+  next = CullFloat4(planes, frustum_count, bounds, next, end,
+                    visibility + (next - begin));
+#endif
+
+  CullScalar(planes, frustum_count, bounds, next, end,
+             visibility + (next - begin));
+}
+
+}  // namespace content
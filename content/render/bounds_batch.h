@@ -0,0 +1,65 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <vector>
+
+#include "content/render/frustum.h"
+
+namespace content {
+
+// Bounds of culling candidates in structure-of-arrays layout, stored as
+// center and half extents. Frustum tests run over four or eight boxes per
+// iteration depending on the instruction set, remaining boxes are tested one
+// by one. Disjoint ranges may be culled from different threads.
+class BoundsBatch {
+ public:
+  BoundsBatch();
+  ~BoundsBatch();
+
+  BoundsBatch(const BoundsBatch&) = delete;
+  BoundsBatch& operator=(const BoundsBatch&) = delete;
+
+  void Resize(size_t count);
+
+  // Stores local bounds transformed by |model| at |index|. The center is
+  // transformed as a point, extents by the absolute rotation and scale part,
+  // which gives the same box as transforming all eight corners. Distinct
+  // indices may be set from different threads.
+  void Set(size_t index,
+           const glm::vec3& bounds_min,
+           const glm::vec3& bounds_max,
+           const glm::mat4& model);
+
+  size_t size() const { return center_x_.size(); }
+  glm::vec3 center(size_t index) const {
+    return glm::vec3(center_x_[index], center_y_[index], center_z_[index]);
+  }
+  glm::vec3 extent(size_t index) const {
+    return glm::vec3(extent_x_[index], extent_y_[index], extent_z_[index]);
+  }
+
+  // Most frustums tested in one pass, one visibility bit each
+  static constexpr uint32_t kMaxFrustums = 32;
+
+  // Tests boxes in [begin, end) against up to kMaxFrustums |frustums| in one
+  // pass, writes one mask per box to |visibility| with bit i set for boxes
+  // intersecting or inside frustum i.
+  void Cull(const Frustum* frustums,
+            uint32_t frustum_count,
+            size_t begin,
+            size_t end,
+            uint32_t* visibility) const;
+
+ private:
+  std::vector<float> center_x_;
+  std::vector<float> center_y_;
+  std::vector<float> center_z_;
+  std::vector<float> extent_x_;
+  std::vector<float> extent_y_;
+  std::vector<float> extent_z_;
+};
+
+}  // namespace content
@@ -0,0 +1,92 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/render/cull_cache.h"
+
+#include <limits>
+
+namespace content {
+
+namespace {
+
+constexpr uint32_t kNotVisible = std::numeric_limits<uint32_t>::max();
+
+}  // namespace
+
+CullCache::CullCache()
+    : world_(nullptr),
+      camera_position_(0.0),
+      view_projection_(1.0f),
+      culling_mask_(0),
+      registry_serial_(0),
+      transform_serial_(0) {}
+
+CullCache::~CullCache() = default;
+
+bool CullCache::Validate(World* world,
+                         const glm::dvec3& camera_position,
+                         const glm::mat4& view_projection,
+                         uint64_t culling_mask) {
+  if (world_ == world && camera_position_ == camera_position &&
+      view_projection_ == view_projection && culling_mask_ == culling_mask &&
+      registry_serial_ == world->registry_serial())
+    return true;
+
+  world_ = world;
+  camera_position_ = camera_position;
+  view_projection_ = view_projection;
+  culling_mask_ = culling_mask;
+  registry_serial_ = world->registry_serial();
+
+  for (const auto& it : visible_)
+    visible_slots_[it.handle] = kNotVisible;
+  visible_.clear();
+
+  return false;
+}
+
+void CullCache::SetVisible(const VisibleRenderer& visible) {
+  if (visible.handle >= visible_slots_.size())
+    visible_slots_.resize(visible.handle + 1, kNotVisible);
+
+  uint32_t& slot = visible_slots_[visible.handle];
+  if (slot == kNotVisible) {
+    slot = static_cast<uint32_t>(visible_.size());
+    visible_.push_back(visible);
+  } else {
+    visible_[slot] = visible;
+  }
+}
+
+void CullCache::SetHidden(World::RendererHandle handle) {
+  if (handle >= visible_slots_.size() || visible_slots_[handle] == kNotVisible)
+    return;
+
+  // Swap-remove, visible order is not significant
+  const uint32_t slot = visible_slots_[handle];
+  if (slot + 1 < visible_.size()) {
+    visible_[slot] = visible_.back();
+    visible_slots_[visible_[slot].handle] = slot;
+  }
+
+  visible_.pop_back();
+  visible_slots_[handle] = kNotVisible;
+}
+
+uint32_t CullCache::GetLODLevel(World::RendererHandle handle,
+                                MeshRenderer* renderer) const {
+  if (handle < lod_states_.size() && lod_states_[handle].renderer == renderer)
+    return lod_states_[handle].level;
+  return kUnknownLODLevel;
+}
+
+void CullCache::SetLODLevel(World::RendererHandle handle,
+                            MeshRenderer* renderer,
+                            uint32_t level) {
+  if (handle >= lod_states_.size())
+    lod_states_.resize(handle + 1, {nullptr, kUnknownLODLevel});
+  lod_states_[handle] = {renderer, level};
+}
+
+}  // namespace content
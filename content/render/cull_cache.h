@@ -0,0 +1,83 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "glm/mat4x4.hpp"
+
+#include "content/scene/world.h"
+
+namespace content {
+
+// Visibility of the previous cull of one camera. While the world, frustum and
+// renderer registry are unchanged the cached visible set stays valid, only
+// renderers whose transforms were recomputed since have to be tested again.
+// Meshes are not cached, they are resolved from the level when emitted.
+class CullCache {
+ public:
+  struct VisibleRenderer {
+    World::RendererHandle handle;
+    MeshRenderer* renderer;
+    glm::mat4 relative_model;
+    uint32_t lod_level;
+    float lod_fade;
+  };
+
+  static constexpr uint32_t kUnknownLODLevel =
+      std::numeric_limits<uint32_t>::max();
+
+  CullCache();
+  ~CullCache();
+
+  CullCache(const CullCache&) = delete;
+  CullCache& operator=(const CullCache&) = delete;
+
+  // Returns whether the cached visibility matches the given cull, resets the
+  // cache for it otherwise.
+  bool Validate(World* world,
+                const glm::dvec3& camera_position,
+                const glm::mat4& view_projection,
+                uint64_t culling_mask);
+
+  void SetVisible(const VisibleRenderer& visible);
+  void SetHidden(World::RendererHandle handle);
+
+  // Level of detail last selected for |renderer| through this camera, kept
+  // across frustum changes for hysteresis.
+  uint32_t GetLODLevel(World::RendererHandle handle,
+                       MeshRenderer* renderer) const;
+  void SetLODLevel(World::RendererHandle handle,
+                   MeshRenderer* renderer,
+                   uint32_t level);
+
+  const std::vector<VisibleRenderer>& visible() const { return visible_; }
+
+  // Transform hierarchy serial the cached visibility was computed at.
+  uint32_t transform_serial() const { return transform_serial_; }
+  void set_transform_serial(uint32_t serial) { transform_serial_ = serial; }
+
+ private:
+  World* world_;
+  glm::dvec3 camera_position_;
+  glm::mat4 view_projection_;
+  uint64_t culling_mask_;
+  uint32_t registry_serial_;
+  uint32_t transform_serial_;
+
+  // Visible set, position in it indexed by renderer handle
+  std::vector<VisibleRenderer> visible_;
+  std::vector<uint32_t> visible_slots_;
+
+  // Indexed by renderer handle, owner validates reused handles
+  struct LODState {
+    MeshRenderer* renderer;
+    uint32_t level;
+  };
+  std::vector<LODState> lod_states_;
+};
+
+}  // namespace content
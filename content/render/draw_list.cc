@@ -0,0 +1,157 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/render/draw_list.h"
+
+#include <algorithm>
+
+#include "content/resource/material.h"
+
+namespace content {
+
+namespace {
+
+constexpr uint32_t kRankShift = 48;
+constexpr uint32_t kDepthShift = 32;
+constexpr uint32_t kPipelineShift = 20;
+constexpr uint32_t kMaterialShift = 8;
+constexpr uint32_t kMeshShift = 0;
+
+constexpr uint32_t kRankBits = 16;
+constexpr uint32_t kDepthBits = 16;
+constexpr uint32_t kPipelineBits = 12;
+constexpr uint32_t kMaterialBits = 12;
+constexpr uint32_t kMeshBits = 8;
+
+uint64_t Field(uint32_t value, uint32_t bits, uint32_t shift) {
+  const uint32_t max_value = (1u << bits) - 1;
+  return uint64_t(std::min(value, max_value)) << shift;
+}
+
+// Position of |value| in the sorted unique |values|
+template <typename T>
+uint32_t RankOf(const std::vector<T>& values, T value) {
+  return static_cast<uint32_t>(
+      std::lower_bound(values.begin(), values.end(), value) - values.begin());
+}
+
+template <typename T>
+void SortUnique(std::vector<T>* values) {
+  std::sort(values->begin(), values->end());
+  values->erase(std::unique(values->begin(), values->end()), values->end());
+}
+
+}  // namespace
+
+DrawList::DrawList() = default;
+
+DrawList::~DrawList() = default;
+
+void DrawList::Clear() {
+  draws_.clear();
+  items_.clear();
+}
+
+DrawList::SortValue DrawList::GetSortValue(const Draw& draw,
+                                           const Criteria& criteria) const {
+  return SortValue(criteria.render_queue ? draw.render_queue : 0,
+                   criteria.order ? draw.order : 0);
+}
+
+void DrawList::Sort(const Criteria& criteria) {
+  // Ranks of the (queue, order) pairs in use, few distinct pairs in practice
+  sort_values_.clear();
+  float max_depth = 0.0f;
+  for (const auto& draw : draws_) {
+    if (criteria.render_queue || criteria.order)
+      sort_values_.push_back(GetSortValue(draw, criteria));
+    max_depth = std::max(max_depth, draw.depth);
+  }
+  SortUnique(&sort_values_);
+
+  // Ranks beyond the field width are ordered by comparison instead
+  const bool rank_overflow = sort_values_.size() > (1u << kRankBits);
+
+  // State identifiers in first use order
+  state_ids_.clear();
+  auto state_id = [&](const void* object) {
+    return state_ids_.try_emplace(object, state_ids_.size()).first->second;
+  };
+
+  const bool by_depth = criteria.back_to_front || criteria.front_to_back;
+  const float depth_scale =
+      max_depth > 0.0f ? ((1u << kDepthBits) - 1) / max_depth : 0.0f;
+
+  items_.resize(draws_.size());
+  for (size_t i = 0; i < draws_.size(); ++i) {
+    const Draw& draw = draws_[i];
+    uint64_t key = 0;
+    if (!sort_values_.empty() && !rank_overflow)
+      key |= Field(RankOf(sort_values_, GetSortValue(draw, criteria)),
+                   kRankBits, kRankShift);
+    if (by_depth) {
+      uint32_t depth = static_cast<uint32_t>(draw.depth * depth_scale);
+      if (criteria.back_to_front)
+        depth = ((1u << kDepthBits) - 1) - depth;
+      key |= Field(depth, kDepthBits, kDepthShift);
+    }
+
+    key |= Field(state_id(draw.pass->pipeline.get()), kPipelineBits,
+                 kPipelineShift);
+    key |= Field(state_id(draw.material), kMaterialBits, kMaterialShift);
+    key |= Field(state_id(draw.mesh), kMeshBits, kMeshShift);
+
+    items_[i] = {key, static_cast<uint32_t>(i)};
+  }
+
+  if (!rank_overflow) {
+    RadixSort();
+    return;
+  }
+
+  std::stable_sort(items_.begin(), items_.end(),
+                   [&](const Item& a, const Item& b) {
+                     const SortValue value_a =
+                         GetSortValue(draws_[a.draw], criteria);
+                     const SortValue value_b =
+                         GetSortValue(draws_[b.draw], criteria);
+                     if (value_a != value_b)
+                       return value_a < value_b;
+                     return a.key < b.key;
+                   });
+}
+
+void DrawList::RadixSort() {
+  constexpr size_t kPasses = sizeof(uint64_t);
+  constexpr size_t kBuckets = 256;
+  if (items_.size() < 2)
+    return;
+
+  // Histograms of all bytes in one read
+  uint32_t counts[kPasses][kBuckets] = {};
+  for (const auto& item : items_)
+    for (size_t pass = 0; pass < kPasses; ++pass)
+      ++counts[pass][(item.key >> (pass * 8)) & 0xFF];
+
+  scratch_.resize(items_.size());
+  for (size_t pass = 0; pass < kPasses; ++pass) {
+    // Byte equal in all keys, order is unchanged
+    const size_t first_bucket = (items_.front().key >> (pass * 8)) & 0xFF;
+    if (counts[pass][first_bucket] == items_.size())
+      continue;
+
+    uint32_t offsets[kBuckets];
+    uint32_t offset = 0;
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+      offsets[bucket] = offset;
+      offset += counts[pass][bucket];
+    }
+
+    for (const auto& item : items_)
+      scratch_[offsets[(item.key >> (pass * 8)) & 0xFF]++] = item;
+    items_.swap(scratch_);
+  }
+}
+
+}  // namespace content
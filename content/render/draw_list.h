@@ -0,0 +1,91 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace content {
+
+class Material;
+class Mesh;
+class ShaderPass;
+class SubMesh;
+struct Renderable;
+
+// Draws of one DrawRenderers call ordered by 64-bit sort keys. Keys hold,
+// from the most significant bits:
+//
+//   (render queue, node order) rank 16 | depth 16 |
+//   pipeline 12 | material 12 | mesh 8
+//
+// Fields of criteria not requested stay zero, the state fields always take
+// part so draws sharing pipeline, material and mesh end up adjacent. The
+// rank and state identifiers are assigned per sort, state identifiers
+// saturate at their width. Sorting is a stable LSD radix sort skipping bytes
+// equal in all keys, or a stable comparison sort when more distinct
+// (queue, order) pairs are in use than the rank holds.
+class DrawList {
+ public:
+  struct Draw {
+    const Renderable* renderable;
+    ShaderPass* pass;
+    Material* material;
+    Mesh* mesh;
+    SubMesh* submesh;
+
+    uint32_t render_queue;
+    int64_t order;
+    // Distance to the sorting position, non-negative
+    float depth;
+  };
+
+  struct Criteria {
+    bool render_queue;
+    bool order;
+    bool back_to_front;
+    bool front_to_back;
+  };
+
+  DrawList();
+  ~DrawList();
+
+  DrawList(const DrawList&) = delete;
+  DrawList& operator=(const DrawList&) = delete;
+
+  void Clear();
+  void Add(const Draw& draw) { draws_.push_back(draw); }
+
+  void Sort(const Criteria& criteria);
+
+  size_t size() const { return items_.size(); }
+  const Draw& operator[](size_t index) const {
+    return draws_[items_[index].draw];
+  }
+
+ private:
+  struct Item {
+    uint64_t key;
+    uint32_t draw;
+  };
+
+  using SortValue = std::pair<uint32_t, int64_t>;
+  SortValue GetSortValue(const Draw& draw, const Criteria& criteria) const;
+
+  void RadixSort();
+
+  std::vector<Draw> draws_;
+  std::vector<Item> items_;
+  std::vector<Item> scratch_;
+
+  // Dense identifiers of state objects and ranks of sort values
+  std::unordered_map<const void*, uint32_t> state_ids_;
+  std::vector<SortValue> sort_values_;
+};
+
+}  // namespace content
@@ -196,6 +196,15 @@ class Frustum {
     }
   }
 
+  /// @brief Move the frustum by an offset, used to bring a camera-relative
+  /// frustum to world space. Computed in double for far away offsets.
+  void Translate(const glm::dvec3& offset) {
+    for (auto& plane : m_planes) {
+      plane.distance = static_cast<float>(
+          plane.distance - glm::dot(glm::dvec3(plane.normal), offset));
+    }
+  }
+
   /// @brief Test if a point is inside the frustum
   [[nodiscard]] bool ContainsPoint(const glm::vec3& point) const {
     for (const auto& plane : m_planes) {
@@ -234,6 +243,37 @@ class Frustum {
     return true;
   }
 
+  /// @brief Mask selecting all planes for IntersectsAABB
+  static constexpr uint32_t kAllPlanes = (1u << Count) - 1;
+
+  /// @brief Test an AABB against the planes selected by |plane_mask| only
+  /// Planes the AABB lies fully inside of are cleared from the mask, boxes
+  /// contained in this one need not test them again. A mask of zero means
+  /// the AABB is fully inside the frustum.
+  [[nodiscard]] bool IntersectsAABB(const AABB& aabb,
+                                    uint32_t* plane_mask) const {
+    for (int32_t i = 0; i < Count; ++i) {
+      const uint32_t plane_bit = 1u << i;
+      if (!(*plane_mask & plane_bit))
+        continue;
+
+      // Corners farthest along and against the plane normal
+      const Plane& plane = m_planes[i];
+      const glm::bvec3 positive =
+          glm::greaterThanEqual(plane.normal, glm::vec3(0.0f));
+      const glm::vec3 pVertex = glm::mix(aabb.min, aabb.max, positive);
+      const glm::vec3 nVertex = glm::mix(aabb.max, aabb.min, positive);
+
+      if (plane.DistanceToPoint(pVertex) < 0.0f) {
+        return false;
+      }
+      if (plane.DistanceToPoint(nVertex) >= 0.0f) {
+        *plane_mask &= ~plane_bit;
+      }
+    }
+    return true;
+  }
+
   /// @brief Get a specific plane
   [[nodiscard]] const Plane& GetPlane(PlaneIndex index) const {
     return m_planes[index];
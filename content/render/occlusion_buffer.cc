@@ -0,0 +1,232 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/render/occlusion_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "content/render/simd.h"
+
+namespace content {
+
+namespace {
+
+// Clip space w below which geometry is treated as crossing the near plane
+constexpr float kMinClipW = 1e-4f;
+
+glm::vec3 ToScreen(const glm::vec4& clip) {
+  const float inv_w = 1.0f / clip.w;
+  return glm::vec3(
+      (clip.x * inv_w * 0.5f + 0.5f) * OcclusionBuffer::kWidth,
+      (clip.y * inv_w * 0.5f + 0.5f) * OcclusionBuffer::kHeight,
+      clip.z * inv_w);
+}
+
+// Pixel index of |value| clamped to the buffer, also guards the conversion
+int32_t ToPixel(float value, int32_t size) {
+  return static_cast<int32_t>(
+      std::clamp(value, 0.0f, static_cast<float>(size - 1)));
+}
+
+}  // namespace
+
+OcclusionBuffer::OcclusionBuffer() {
+  int32_t width = kWidth;
+  int32_t height = kHeight;
+  while (true) {
+    levels_.push_back({width, height, std::vector<float>(width * height)});
+    if (width == 1 && height == 1)
+      break;
+    width = std::max(1, (width + 1) / 2);
+    height = std::max(1, (height + 1) / 2);
+  }
+
+  Clear();
+}
+
+OcclusionBuffer::~OcclusionBuffer() = default;
+
+void OcclusionBuffer::Clear() {
+  auto& depth = levels_.front().depth;
+  std::fill(depth.begin(), depth.end(), 1.0f);
+}
+
+void OcclusionBuffer::RasterizeTriangles(
+    const glm::mat4& model_view_projection,
+    const uint8_t* vertices,
+    uint32_t stride,
+    uint32_t vertex_count,
+    const uint32_t* indices,
+    uint32_t index_count,
+    uint32_t base_vertex) {
+  auto load_vertex = [&](uint32_t index, glm::vec4* clip) {
+    const uint32_t vertex = base_vertex + index;
+    if (vertex >= vertex_count)
+      return false;
+
+    glm::vec3 position;
+    std::memcpy(&position, vertices + uint64_t(vertex) * stride,
+                sizeof(position));
+    *clip = model_view_projection * glm::vec4(position, 1.0f);
+    return clip->w > kMinClipW;
+  };
+
+  for (uint32_t i = 0; i + 2 < index_count; i += 3) {
+    glm::vec4 clip[3];
+    if (!load_vertex(indices[i], &clip[0]) ||
+        !load_vertex(indices[i + 1], &clip[1]) ||
+        !load_vertex(indices[i + 2], &clip[2]))
+      continue;
+
+    RasterizeTriangle(ToScreen(clip[0]), ToScreen(clip[1]),
+                      ToScreen(clip[2]));
+  }
+}
+
+void OcclusionBuffer::RasterizeTriangle(const glm::vec3& v0,
+                                        const glm::vec3& v1,
+                                        const glm::vec3& v2) {
+  // Both windings are rasterized, orient edges to positive area
+  float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+  if (std::abs(area) < 1e-8f)
+    return;
+
+  const glm::vec3& a = v0;
+  const glm::vec3& b = area > 0.0f ? v1 : v2;
+  const glm::vec3& c = area > 0.0f ? v2 : v1;
+  area = std::abs(area);
+
+  // Pixel bounds, columns aligned to the lane count
+  const float left = std::min({a.x, b.x, c.x});
+  const float right = std::max({a.x, b.x, c.x});
+  const float bottom = std::min({a.y, b.y, c.y});
+  const float top = std::max({a.y, b.y, c.y});
+  if (right < 0.0f || left >= kWidth || top < 0.0f || bottom >= kHeight)
+    return;
+
+  const int32_t min_x = ToPixel(std::floor(left), kWidth) & ~3;
+  const int32_t max_x = ToPixel(std::ceil(right), kWidth);
+  const int32_t min_y = ToPixel(std::floor(bottom), kHeight);
+  const int32_t max_y = ToPixel(std::ceil(top), kHeight);
+
+  // Edge functions E(x, y) = A * x + B * y + C, positive inside
+  struct Edge {
+    float a, b, c;
+  };
+  auto make_edge = [](const glm::vec3& from, const glm::vec3& to) {
+    return Edge{from.y - to.y, to.x - from.x,
+                from.x * to.y - from.y * to.x};
+  };
+  const Edge e0 = make_edge(b, c);
+  const Edge e1 = make_edge(c, a);
+  const Edge e2 = make_edge(a, b);
+
+  // Depth plane from barycentric weights
+  const float inv_area = 1.0f / area;
+  const float dz_dx = (e0.a * a.z + e1.a * b.z + e2.a * c.z) * inv_area;
+  const float dz_dy = (e0.b * a.z + e1.b * b.z + e2.b * c.z) * inv_area;
+  const float z_c = (e0.c * a.z + e1.c * b.z + e2.c * c.z) * inv_area;
+
+  const simd::Float4 lane_offsets = simd::Set(0.5f, 1.5f, 2.5f, 3.5f);
+  const simd::Float4 zero = simd::Set1(0.0f);
+  float* depth = levels_.front().depth.data();
+
+  for (int32_t y = min_y; y <= max_y; ++y) {
+    const float py = y + 0.5f;
+    float* row = depth + y * kWidth;
+    for (int32_t x = min_x; x <= max_x; x += 4) {
+      const simd::Float4 px = simd::Set1(static_cast<float>(x)) + lane_offsets;
+
+      const simd::Float4 w0 =
+          simd::Set1(e0.a) * px + simd::Set1(e0.b * py + e0.c);
+      const simd::Float4 w1 =
+          simd::Set1(e1.a) * px + simd::Set1(e1.b * py + e1.c);
+      const simd::Float4 w2 =
+          simd::Set1(e2.a) * px + simd::Set1(e2.b * py + e2.c);
+      const simd::Float4 inside = simd::CmpGe(w0, zero) &
+                                  simd::CmpGe(w1, zero) &
+                                  simd::CmpGe(w2, zero);
+      if (!simd::MoveMask(inside))
+        continue;
+
+      const simd::Float4 z =
+          simd::Set1(dz_dx) * px + simd::Set1(dz_dy * py + z_c);
+      const simd::Float4 current = simd::Load(row + x);
+      simd::Store(row + x,
+                  simd::Select(inside, simd::Min(current, z), current));
+    }
+  }
+}
+
+void OcclusionBuffer::BuildHierarchy() {
+  for (size_t i = 1; i < levels_.size(); ++i) {
+    const Level& source = levels_[i - 1];
+    Level& target = levels_[i];
+
+    for (int32_t y = 0; y < target.height; ++y) {
+      const int32_t y0 = y * 2;
+      const int32_t y1 = std::min(y0 + 1, source.height - 1);
+      for (int32_t x = 0; x < target.width; ++x) {
+        const int32_t x0 = x * 2;
+        const int32_t x1 = std::min(x0 + 1, source.width - 1);
+        target.depth[y * target.width + x] =
+            std::max(std::max(source.depth[y0 * source.width + x0],
+                              source.depth[y0 * source.width + x1]),
+                     std::max(source.depth[y1 * source.width + x0],
+                              source.depth[y1 * source.width + x1]));
+      }
+    }
+  }
+}
+
+bool OcclusionBuffer::IsVisible(const AABB& box,
+                                const glm::mat4& view_projection) const {
+  glm::vec2 screen_min(std::numeric_limits<float>::max());
+  glm::vec2 screen_max(std::numeric_limits<float>::lowest());
+  float nearest = std::numeric_limits<float>::max();
+  for (int32_t i = 0; i < 8; ++i) {
+    const glm::vec4 corner((i & 1) ? box.max.x : box.min.x,
+                           (i & 2) ? box.max.y : box.min.y,
+                           (i & 4) ? box.max.z : box.min.z, 1.0f);
+    const glm::vec4 clip = view_projection * corner;
+
+    // Crossing the near plane, too close to be hidden
+    if (clip.w <= kMinClipW)
+      return true;
+
+    const glm::vec3 screen = ToScreen(clip);
+    screen_min = glm::min(screen_min, glm::vec2(screen));
+    screen_max = glm::max(screen_max, glm::vec2(screen));
+    nearest = std::min(nearest, screen.z);
+  }
+
+  // Outside of the buffer, left to the frustum test
+  if (screen_max.x < 0.0f || screen_min.x >= kWidth || screen_max.y < 0.0f ||
+      screen_min.y >= kHeight)
+    return true;
+
+  const int32_t min_x = ToPixel(screen_min.x, kWidth);
+  const int32_t min_y = ToPixel(screen_min.y, kHeight);
+  const int32_t max_x = ToPixel(screen_max.x, kWidth);
+  const int32_t max_y = ToPixel(screen_max.y, kHeight);
+
+  // Level where the footprint spans at most two texels per axis
+  const int32_t extent = std::max(max_x - min_x, max_y - min_y);
+  size_t level = 0;
+  while ((extent >> level) > 1 && level + 1 < levels_.size())
+    ++level;
+
+  const Level& hierarchy = levels_[level];
+  for (int32_t y = min_y >> level; y <= (max_y >> level); ++y)
+    for (int32_t x = min_x >> level; x <= (max_x >> level); ++x)
+      if (nearest <= hierarchy.depth[y * hierarchy.width + x])
+        return true;
+
+  return false;
+}
+
+}  // namespace content
@@ -0,0 +1,62 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <vector>
+
+#include "content/render/frustum.h"
+
+namespace content {
+
+// Low resolution depth buffer of occluders rasterized on the CPU. Depth is
+// post projection depth in [0, 1], cleared to the far plane. Boxes are tested
+// against a pyramid of the farthest depth per texel, picking the level at
+// which the projected box covers a few texels only.
+class OcclusionBuffer {
+ public:
+  static constexpr int32_t kWidth = 256;
+  static constexpr int32_t kHeight = 128;
+
+  OcclusionBuffer();
+  ~OcclusionBuffer();
+
+  OcclusionBuffer(const OcclusionBuffer&) = delete;
+  OcclusionBuffer& operator=(const OcclusionBuffer&) = delete;
+
+  void Clear();
+
+  // Rasterizes an indexed triangle list of float3 positions read with
+  // |stride| from |vertices|. Triangles crossing the near plane are skipped,
+  // occluders only ever hide less than they cover.
+  void RasterizeTriangles(const glm::mat4& model_view_projection,
+                          const uint8_t* vertices,
+                          uint32_t stride,
+                          uint32_t vertex_count,
+                          const uint32_t* indices,
+                          uint32_t index_count,
+                          uint32_t base_vertex);
+
+  // Builds the depth pyramid, required before testing.
+  void BuildHierarchy();
+
+  // Whether |box| transformed by |view_projection| may be visible.
+  bool IsVisible(const AABB& box, const glm::mat4& view_projection) const;
+
+ private:
+  struct Level {
+    int32_t width;
+    int32_t height;
+    std::vector<float> depth;
+  };
+
+  void RasterizeTriangle(const glm::vec3& v0,
+                         const glm::vec3& v1,
+                         const glm::vec3& v2);
+
+  // Level zero is the rasterized depth
+  std::vector<Level> levels_;
+};
+
+}  // namespace content
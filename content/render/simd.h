@@ -0,0 +1,235 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "base/buildflags/build.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) &&                   \
+    (defined(__SSE2__) || defined(_M_X64) ||          \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define URGE_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64) || defined(__ARM_NEON)
+#define URGE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace content {
+namespace simd {
+
+// Four lanes of float, comparisons return lane masks. Bitwise operations
+// are meant for combining masks.
+struct Float4 {
+#if defined(URGE_SIMD_SSE2)
+  __m128 v;
+#elif defined(URGE_SIMD_NEON)
+  float32x4_t v;
+#else
+  float v[4];
+#endif
+};
+
+#if defined(URGE_SIMD_SSE2)
+
+inline Float4 Set1(float value) {
+  return {_mm_set1_ps(value)};
+}
+inline Float4 Set(float a, float b, float c, float d) {
+  return {_mm_setr_ps(a, b, c, d)};
+}
+inline Float4 Load(const float* data) {
+  return {_mm_loadu_ps(data)};
+}
+inline void Store(float* data, Float4 a) {
+  _mm_storeu_ps(data, a.v);
+}
+inline Float4 operator+(Float4 a, Float4 b) {
+  return {_mm_add_ps(a.v, b.v)};
+}
+inline Float4 operator-(Float4 a, Float4 b) {
+  return {_mm_sub_ps(a.v, b.v)};
+}
+inline Float4 operator*(Float4 a, Float4 b) {
+  return {_mm_mul_ps(a.v, b.v)};
+}
+inline Float4 Min(Float4 a, Float4 b) {
+  return {_mm_min_ps(a.v, b.v)};
+}
+inline Float4 Max(Float4 a, Float4 b) {
+  return {_mm_max_ps(a.v, b.v)};
+}
+inline Float4 Abs(Float4 a) {
+  return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+}
+inline Float4 CmpGe(Float4 a, Float4 b) {
+  return {_mm_cmpge_ps(a.v, b.v)};
+}
+inline Float4 CmpLt(Float4 a, Float4 b) {
+  return {_mm_cmplt_ps(a.v, b.v)};
+}
+inline Float4 operator&(Float4 a, Float4 b) {
+  return {_mm_and_ps(a.v, b.v)};
+}
+inline Float4 operator|(Float4 a, Float4 b) {
+  return {_mm_or_ps(a.v, b.v)};
+}
+inline Float4 Select(Float4 mask, Float4 a, Float4 b) {
+  return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+}
+inline uint32_t MoveMask(Float4 mask) {
+  return static_cast<uint32_t>(_mm_movemask_ps(mask.v));
+}
+
+#elif defined(URGE_SIMD_NEON)
+
+inline Float4 Set1(float value) {
+  return {vdupq_n_f32(value)};
+}
+inline Float4 Set(float a, float b, float c, float d) {
+  const float data[4] = {a, b, c, d};
+  return {vld1q_f32(data)};
+}
+inline Float4 Load(const float* data) {
+  return {vld1q_f32(data)};
+}
+inline void Store(float* data, Float4 a) {
+  vst1q_f32(data, a.v);
+}
+inline Float4 operator+(Float4 a, Float4 b) {
+  return {vaddq_f32(a.v, b.v)};
+}
+inline Float4 operator-(Float4 a, Float4 b) {
+  return {vsubq_f32(a.v, b.v)};
+}
+inline Float4 operator*(Float4 a, Float4 b) {
+  return {vmulq_f32(a.v, b.v)};
+}
+inline Float4 Min(Float4 a, Float4 b) {
+  return {vminq_f32(a.v, b.v)};
+}
+inline Float4 Max(Float4 a, Float4 b) {
+  return {vmaxq_f32(a.v, b.v)};
+}
+inline Float4 Abs(Float4 a) {
+  return {vabsq_f32(a.v)};
+}
+inline Float4 CmpGe(Float4 a, Float4 b) {
+  return {vreinterpretq_f32_u32(vcgeq_f32(a.v, b.v))};
+}
+inline Float4 CmpLt(Float4 a, Float4 b) {
+  return {vreinterpretq_f32_u32(vcltq_f32(a.v, b.v))};
+}
+inline Float4 operator&(Float4 a, Float4 b) {
+  return {vreinterpretq_f32_u32(
+      vandq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)))};
+}
+inline Float4 operator|(Float4 a, Float4 b) {
+  return {vreinterpretq_f32_u32(
+      vorrq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)))};
+}
+inline Float4 Select(Float4 mask, Float4 a, Float4 b) {
+  return {vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v)};
+}
+inline uint32_t MoveMask(Float4 mask) {
+  const uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(mask.v), 31);
+  const uint32_t lanes[4] = {vgetq_lane_u32(bits, 0), vgetq_lane_u32(bits, 1),
+                             vgetq_lane_u32(bits, 2), vgetq_lane_u32(bits, 3)};
+  return lanes[0] | (lanes[1] << 1) | (lanes[2] << 2) | (lanes[3] << 3);
+}
+
+#else
+
+namespace internal {
+
+inline float MaskLane(bool value) {
+  const uint32_t bits = value ? 0xFFFFFFFFu : 0u;
+  float lane;
+  std::memcpy(&lane, &bits, sizeof(lane));
+  return lane;
+}
+
+inline uint32_t LaneBits(float lane) {
+  uint32_t bits;
+  std::memcpy(&bits, &lane, sizeof(bits));
+  return bits;
+}
+
+template <typename Op>
+inline Float4 Apply(Float4 a, Float4 b, Op op) {
+  return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]),
+           op(a.v[3], b.v[3])}};
+}
+
+}  // namespace internal
+
+inline Float4 Set1(float value) {
+  return {{value, value, value, value}};
+}
+inline Float4 Set(float a, float b, float c, float d) {
+  return {{a, b, c, d}};
+}
+inline Float4 Load(const float* data) {
+  return {{data[0], data[1], data[2], data[3]}};
+}
+inline void Store(float* data, Float4 a) {
+  for (int i = 0; i < 4; ++i)
+    data[i] = a.v[i];
+}
+inline Float4 operator+(Float4 a, Float4 b) {
+  return internal::Apply(a, b, [](float x, float y) { return x + y; });
+}
+inline Float4 operator-(Float4 a, Float4 b) {
+  return internal::Apply(a, b, [](float x, float y) { return x - y; });
+}
+inline Float4 operator*(Float4 a, Float4 b) {
+  return internal::Apply(a, b, [](float x, float y) { return x * y; });
+}
+inline Float4 Min(Float4 a, Float4 b) {
+  return internal::Apply(a, b, [](float x, float y) { return y < x ? y : x; });
+}
+inline Float4 Max(Float4 a, Float4 b) {
+  return internal::Apply(a, b, [](float x, float y) { return x < y ? y : x; });
+}
+inline Float4 Abs(Float4 a) {
+  return internal::Apply(a, a, [](float x, float) { return x < 0 ? -x : x; });
+}
+inline Float4 CmpGe(Float4 a, Float4 b) {
+  return internal::Apply(
+      a, b, [](float x, float y) { return internal::MaskLane(x >= y); });
+}
+inline Float4 CmpLt(Float4 a, Float4 b) {
+  return internal::Apply(
+      a, b, [](float x, float y) { return internal::MaskLane(x < y); });
+}
+inline Float4 operator&(Float4 a, Float4 b) {
+  return internal::Apply(a, b, [](float x, float y) {
+    return internal::MaskLane(internal::LaneBits(x) & internal::LaneBits(y));
+  });
+}
+inline Float4 operator|(Float4 a, Float4 b) {
+  return internal::Apply(a, b, [](float x, float y) {
+    return internal::MaskLane(internal::LaneBits(x) | internal::LaneBits(y));
+  });
+}
+inline Float4 Select(Float4 mask, Float4 a, Float4 b) {
+  Float4 result;
+  for (int i = 0; i < 4; ++i)
+    result.v[i] = internal::LaneBits(mask.v[i]) ? a.v[i] : b.v[i];
+  return result;
+}
+inline uint32_t MoveMask(Float4 mask) {
+  uint32_t bits = 0;
+  for (int i = 0; i < 4; ++i)
+    bits |= (internal::LaneBits(mask.v[i]) >> 31) << i;
+  return bits;
+}
+
+#endif
+
+}  // namespace simd
+}  // namespace content
@@ -4,16 +4,52 @@
 
 #include "content/render/viewport.h"
 
+#include <algorithm>
+#include <chrono>
 #include <limits>
 
 #include "glm/gtc/matrix_access.hpp"
 #include "glm/gtc/matrix_inverse.hpp"
 
+#include "base/thread/worker_pool.h"
+#include "content/render/draw_list.h"
 #include "content/render/frustum.h"
 #include "content/render/graphics.h"
+#include "content/render/occlusion_buffer.h"
 
 namespace content {
 
+namespace {
+
+void RasterizeOccluder(OcclusionBuffer* buffer,
+                       Mesh* mesh,
+                       const glm::mat4& model_view_projection) {
+  if (!mesh || !mesh->has_layout())
+    return;
+
+  // Vertices whose position lies completely within the vertex data
+  const auto& vertices = mesh->vertices();
+  const auto& indices = mesh->indices();
+  const uint32_t stride = mesh->vertex_stride();
+  const uint32_t position_offset = mesh->position_offset();
+  if (vertices.size() < position_offset + sizeof(glm::vec3))
+    return;
+  const uint32_t vertex_count = static_cast<uint32_t>(
+      (vertices.size() - position_offset - sizeof(glm::vec3)) / stride + 1);
+
+  for (const auto& submesh : mesh->mesh_group()) {
+    if (uint64_t(submesh->indexStart) + submesh->indexCount > indices.size())
+      continue;
+
+    buffer->RasterizeTriangles(
+        model_view_projection, vertices.data() + position_offset, stride,
+        vertex_count, indices.data() + submesh->indexStart,
+        submesh->indexCount, submesh->vertexStart);
+  }
+}
+
+}  // namespace
+
 ///
 /// RenderContext
 ///
@@ -25,7 +61,12 @@ RenderContext::RenderContext(World* world,
     : world_(world),
       queue_(queue),
       render_target_view_(rtv),
-      depth_stencil_view_(dsv) {}
+      depth_stencil_view_(dsv),
+      draw_calls_(0),
+      state_changes_issued_(0),
+      state_changes_skipped_(0),
+      cull_candidates_(0),
+      cull_milliseconds_(0.0) {}
 
 scoped_refptr<GPUQueue> RenderContext::GetQueue(URGE_EXCEPTION) {
   return queue_;
@@ -49,80 +90,464 @@ scoped_refptr<CullingResults> RenderContext::Cull(scoped_refptr<Camera> camera,
 
   // Camera world position (double) + rotation-only view for origin-centered
   // frustum
-  auto* camera_transform = camera->transform();
-  const auto camera_position = camera_transform->position();
-  const glm::mat4 camera_view =
-      glm::affineInverse(camera_transform->GetForwardMatrix());
-  const glm::mat4 camera_view_projection =
-      camera->GetProjectionMatrix() * camera_view;
+  const glm::dvec3 camera_position = camera->GetWorldPosition();
+  const glm::mat4 camera_view_projection = camera->GetRelativeViewProjection();
 
   // Frustum planes centered at origin (camera-relative world space)
   Frustum frustum;
   frustum.ExtractFromMatrix(camera_view_projection);
 
-  for (auto* renderer : world_->renderers_) {
-    // 1. Fast reject: culling mask
-    if (!(renderer->layer() & camera->culling_mask()))
+  // Renderer tree is queried in world space
+  Frustum world_frustum = frustum;
+  world_frustum.Translate(camera_position);
+
+  // World matrices were resolved by the transform stage
+  world_->UpdateSpatialIndex();
+  const uint32_t transform_serial = world_->transform_hierarchy()->serial();
+
+  const uint64_t culling_mask = camera->culling_mask();
+  CullCache& cache = camera->cull_cache();
+
+  // 1. Gather candidates, rejecting by culling mask and static batch first
+  cull_handles_.clear();
+  auto gather_renderer = [&](uint32_t handle, const RendererEntry& entry) {
+    if (!(entry.layer & culling_mask) ||
+        (entry.flags & RendererEntry::kBatched)) {
+      cache.SetHidden(handle);
+      return;
+    }
+
+    cull_handles_.push_back(handle);
+  };
+
+  if (cache.Validate(world_, camera_position, camera_view_projection,
+                     culling_mask)) {
+    // Same frustum and registry: only renderers moved since the cached cull
+    // are tested again, none if no transform changed.
+    if (cache.transform_serial() != transform_serial) {
+      const auto& renderers = world_->renderers_;
+      for (size_t i = 0; i < renderers.size(); ++i) {
+        const RendererEntry& entry = renderers.data()[i];
+        if (entry.generation > cache.transform_serial())
+          gather_renderer(renderers.handle_at(i), entry);
+      }
+    }
+  } else {
+    world_->renderer_tree().Query(world_frustum, [&](uint32_t handle) {
+      gather_renderer(handle, world_->renderers_[handle]);
+    });
+  }
+  cache.set_transform_serial(transform_serial);
+
+  // 2. Frustum cull all candidates against origin-centered planes (single
+  // precision)
+  CullCandidates(camera_position, &frustum, 1);
+  const size_t candidate_count = cull_handles_.size();
+
+  // 3. Level of detail of the candidates passing the frustum
+  for (size_t i = 0; i < candidate_count; ++i) {
+    const uint32_t handle = cull_handles_[i];
+    CullCache::VisibleRenderer visible;
+    if (!cull_visibility_[i] ||
+        !SelectLevelOfDetail(camera.get(), handle, cull_models_[i],
+                             cull_bounds_.center(i), cull_bounds_.extent(i),
+                             &visible)) {
+      cache.SetHidden(handle);
       continue;
+    }
+
+    cache.SetVisible(visible);
+  }
+
+  EmitRenderables(camera.get(), camera_view_projection, cache.visible(),
+                  results.get());
+  return results;
+}
 
-    // 2. Compute camera-relative model: translation offset only
-    const glm::mat4 rel_model = renderer->GetModelMatrix(camera_position);
-
-    // 3. Transform AABB to camera-relative space (double precision)
-    AABB renderer_local_aabb(renderer->bounds_min_data(),
-                             renderer->bounds_max_data());
-    renderer_local_aabb.Transform(rel_model);
-
-    // 4. Frustum cull against origin-centered planes (single precision)
-    if (frustum.IntersectsAABB(renderer_local_aabb)) {
-      Renderable renderable;
-      renderable.host_node = renderer;
-      renderable.cast_camera = camera.get();
-      renderable.relative_transform = glm::mat4(rel_model);
-      results->visible_renderers_.push_back(std::move(renderable));
+earray<scoped_refptr<CullingResults>> RenderContext::CullMany(
+    earray<scoped_refptr<Camera>> cameras,
+    URGE_EXCEPTION) {
+  if (cameras.size() > BoundsBatch::kMaxFrustums) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                          "too many cameras to cull at once.");
+    return {};
+  }
+
+  earray<scoped_refptr<CullingResults>> results;
+  for (size_t i = 0; i < cameras.size(); ++i)
+    results.push_back(Object::Create<CullingResults>());
+
+  // Bounds are made relative to the first camera, the frustums of the others
+  // are moved there
+  glm::dvec3 origin(0.0);
+  for (const auto& camera : cameras) {
+    if (camera) {
+      origin = camera->GetWorldPosition();
+      break;
     }
   }
 
+  struct View {
+    Camera* camera;
+    glm::dvec3 position;
+    glm::mat4 view_projection;
+  };
+
+  std::vector<View> views(cameras.size());
+  Frustum frustums[BoundsBatch::kMaxFrustums];
+  uint32_t view_mask = 0;
+  for (size_t i = 0; i < cameras.size(); ++i) {
+    if (!cameras[i])
+      continue;
+
+    View& view = views[i];
+    view.camera = cameras[i].get();
+    view.position = view.camera->GetWorldPosition();
+    view.view_projection = view.camera->GetRelativeViewProjection();
+    frustums[i].ExtractFromMatrix(view.view_projection);
+    frustums[i].Translate(view.position - origin);
+    view_mask |= 1u << i;
+  }
+
+  world_->UpdateSpatialIndex();
+
+  // 1. Gather every renderer seen by any camera once, with the cameras whose
+  // culling mask and tree query accepted it
+  cull_handles_.clear();
+  cull_view_masks_.clear();
+  for (size_t i = 0; i < cameras.size(); ++i) {
+    if (!(view_mask & (1u << i)))
+      continue;
+
+    Frustum world_frustum = frustums[i];
+    world_frustum.Translate(origin);
+    const uint64_t culling_mask = views[i].camera->culling_mask();
+    world_->renderer_tree().Query(world_frustum, [&](uint32_t handle) {
+      const RendererEntry& entry = world_->renderers_[handle];
+      if (!(entry.layer & culling_mask) ||
+          (entry.flags & RendererEntry::kBatched))
+        return;
+
+      if (handle >= cull_slots_.size())
+        cull_slots_.resize(handle + 1, kInvalidCullSlot);
+
+      uint32_t& slot = cull_slots_[handle];
+      if (slot == kInvalidCullSlot) {
+        slot = static_cast<uint32_t>(cull_handles_.size());
+        cull_handles_.push_back(handle);
+        cull_view_masks_.push_back(0);
+      }
+      cull_view_masks_[slot] |= 1u << i;
+    });
+  }
+  for (uint32_t handle : cull_handles_)
+    cull_slots_[handle] = kInvalidCullSlot;
+
+  // 2. All frustums tested in one pass over the bounds
+  CullCandidates(origin, frustums, static_cast<uint32_t>(cameras.size()));
+  const size_t candidate_count = cull_handles_.size();
+
+  // 3. Level of detail and output per camera
+  for (size_t i = 0; i < cameras.size(); ++i) {
+    if (!(view_mask & (1u << i)))
+      continue;
+
+    const View& view = views[i];
+    const glm::vec3 offset(view.position - origin);
+    cull_visible_set_.clear();
+    for (size_t c = 0; c < candidate_count; ++c) {
+      if (!(cull_visibility_[c] & cull_view_masks_[c] & (1u << i)))
+        continue;
+
+      const RendererEntry& entry = world_->renderers_[cull_handles_[c]];
+      CullCache::VisibleRenderer visible;
+      if (SelectLevelOfDetail(view.camera, cull_handles_[c],
+                              GetRelativeModel(entry, view.position),
+                              cull_bounds_.center(c) - offset,
+                              cull_bounds_.extent(c), &visible))
+        cull_visible_set_.push_back(visible);
+    }
+
+    EmitRenderables(view.camera, view.view_projection, cull_visible_set_,
+                    results[i].get());
+  }
+
   return results;
 }
 
+void RenderContext::CullCandidates(const glm::dvec3& origin,
+                                   const Frustum* frustums,
+                                   uint32_t frustum_count) {
+  const size_t candidate_count = cull_handles_.size();
+  cull_models_.resize(candidate_count);
+  cull_bounds_.Resize(candidate_count);
+  cull_visibility_.resize(candidate_count);
+  const auto start_time = std::chrono::steady_clock::now();
+
+  // Chunks write disjoint candidate ranges, the output keeps the gather order
+  // whatever the thread count
+  base::WorkerPool::GetDefault()->ParallelFor(
+      candidate_count, kCullGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          const RendererEntry& entry = world_->renderers_[cull_handles_[i]];
+          cull_models_[i] = GetRelativeModel(entry, origin);
+          cull_bounds_.Set(i, entry.bounds_min, entry.bounds_max,
+                           cull_models_[i]);
+        }
+
+        cull_bounds_.Cull(frustums, frustum_count, begin, end,
+                          cull_visibility_.data() + begin);
+      });
+
+  cull_candidates_ += candidate_count;
+  cull_milliseconds_ += std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start_time)
+                            .count();
+}
+
+glm::mat4 RenderContext::GetRelativeModel(const RendererEntry& entry,
+                                          const glm::dvec3& origin) {
+  // Camera-relative model from the cached world matrix
+  glm::dmat4x4 model =
+      world_->transform_hierarchy()->world_matrix(entry.transform);
+  model[3] -= glm::dvec4(origin, 0.0);
+  return glm::mat4(model);
+}
+
+bool RenderContext::SelectLevelOfDetail(Camera* camera,
+                                        uint32_t handle,
+                                        const glm::mat4& relative_model,
+                                        const glm::vec3& center,
+                                        const glm::vec3& extent,
+                                        CullCache::VisibleRenderer* visible) {
+  const RendererEntry& entry = world_->renderers_[handle];
+  visible->handle = handle;
+  visible->renderer = entry.renderer;
+  visible->relative_model = relative_model;
+  visible->lod_level = 0;
+  visible->lod_fade = 1.0f;
+
+  // Groups without levels draw the renderer mesh
+  LODGroup* lod_group = entry.lod_group;
+  if (!lod_group || lod_group->levels().empty())
+    return true;
+
+  // Projected height of the bounding sphere, the camera sits at the origin
+  // of camera-relative space
+  const glm::mat4& projection = camera->GetProjectionMatrix();
+  const float radius = glm::length(extent);
+  const float clip_w =
+      glm::length(center) * std::abs(projection[2][3]) + projection[3][3];
+  const float screen_height =
+      radius * projection[1][1] / std::max(clip_w, camera->near_plane());
+
+  CullCache& cache = camera->cull_cache();
+  const uint32_t level = lod_group->SelectLevel(
+      screen_height, cache.GetLODLevel(handle, entry.renderer));
+  cache.SetLODLevel(handle, entry.renderer, level);
+  if (level >= lod_group->levels().size())
+    return false;
+
+  visible->lod_level = level;
+  visible->lod_fade = lod_group->GetFade(screen_height, level);
+  return true;
+}
+
+void RenderContext::EmitRenderables(
+    Camera* camera,
+    const glm::mat4& view_projection,
+    const std::vector<CullCache::VisibleRenderer>& visible,
+    CullingResults* results) {
+  // Occlusion stage: occluders passing the frustum are rasterized, all other
+  // renderers are tested against their depth
+  OcclusionBuffer* occlusion = nullptr;
+  if (camera->occlusion_culling()) {
+    occlusion = camera->GetOcclusionBuffer();
+    occlusion->Clear();
+    for (const auto& it : visible)
+      if (world_->renderers_[it.handle].flags & RendererEntry::kOccluder)
+        RasterizeOccluder(occlusion, it.renderer->GetLevelMesh(it.lod_level),
+                          view_projection * it.relative_model);
+    occlusion->BuildHierarchy();
+  }
+
+  results->visible_renderers_.reserve(visible.size());
+  for (const auto& it : visible) {
+    if (occlusion) {
+      const RendererEntry& entry = world_->renderers_[it.handle];
+      if (!(entry.flags & RendererEntry::kOccluder) &&
+          !occlusion->IsVisible(AABB(entry.bounds_min, entry.bounds_max),
+                                view_projection * it.relative_model))
+        continue;
+    }
+
+    Renderable renderable;
+    renderable.host_node = it.renderer;
+    renderable.cast_camera = camera;
+    renderable.relative_transform = it.relative_model;
+    renderable.mesh = it.renderer->GetLevelMesh(it.lod_level);
+    renderable.lod_level = it.lod_level;
+    renderable.lod_fade = it.lod_fade;
+    results->visible_renderers_.push_back(std::move(renderable));
+  }
+}
+
 void RenderContext::DrawRenderers(
     scoped_refptr<GPURenderPassEncoder> pass,
     scoped_refptr<CullingResults> culling_results,
     scoped_refptr<DrawingSettings> drawing_settings,
     scoped_refptr<FilteringSettings> filtering_settings,
     URGE_EXCEPTION) {
+  if (!pass || !culling_results || !drawing_settings) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                          "invalid draw renderers arguments.");
+    return;
+  }
+
   // Filter material
-  uint64_t culling_mask =
-      filtering_settings ? filtering_settings->cullingMask : 0;
+  uint64_t culling_mask = filtering_settings
+                              ? filtering_settings->cullingMask
+                              : std::numeric_limits<uint64_t>::max();
   uint32_t min_render_queue =
       filtering_settings ? filtering_settings->minRenderQueue : 0;
   uint32_t max_render_queue = filtering_settings
                                   ? filtering_settings->maxRenderQueue
                                   : std::numeric_limits<uint32_t>::max();
 
+  // Sorting criteria, depth is measured from the sorting position if set or
+  // from the culling camera
+  DrawList::Criteria criteria = {};
+  const auto& sorting_settings = drawing_settings->sortingSettings;
+  if (sorting_settings) {
+    auto has = [&](SortingSettings::SortingCriteria flag) {
+      return !!(static_cast<uint64_t>(sorting_settings->criteria) &
+                static_cast<uint64_t>(flag));
+    };
+    criteria.render_queue = has(SortingSettings::SortingCriteria::RenderQueue);
+    criteria.order = has(SortingSettings::SortingCriteria::OrderSorting);
+    criteria.back_to_front =
+        has(SortingSettings::SortingCriteria::BackToFront);
+    criteria.front_to_back =
+        !criteria.back_to_front &&
+        has(SortingSettings::SortingCriteria::FrontToBack);
+  }
+
+  Camera* sorting_camera = nullptr;
+  glm::vec3 sorting_offset(0.0f);
+
+  // Collect renderable
+  draw_list_.Clear();
   for (auto& renderable : culling_results->visible_renderers_) {
     auto* renderer = renderable.host_node;
-    // Culling mask
-    if (renderer->layer() & culling_mask) {
-      for (auto& material : renderer->materials()) {
-        // Render queue
-        if (material->render_queue() >= min_render_queue &&
-            material->render_queue() <= max_render_queue) {
-          for (auto& pass : material->passes()) {
-            // Pass name
-            if (pass->passName == drawing_settings->passName) {
-              // Collect renderable
-            }
-          }
-        }
+    Mesh* mesh = renderable.mesh;
+    if (!(renderer->layer() & culling_mask) || !mesh)
+      continue;
+
+    if (sorting_settings && sorting_settings->cameraPosition &&
+        renderable.cast_camera != sorting_camera) {
+      sorting_camera = renderable.cast_camera;
+      sorting_offset = glm::vec3(sorting_settings->cameraPosition->data() -
+                                 sorting_camera->GetWorldPosition());
+    }
+    const float depth = glm::length(
+        glm::vec3(renderable.relative_transform[3]) - sorting_offset);
+
+    const auto& materials = renderer->materials();
+    for (const auto& submesh : mesh->mesh_group()) {
+      if (!submesh || submesh->materialSlot >= materials.size())
+        continue;
+
+      Material* material = materials[submesh->materialSlot].get();
+      // Render queue
+      if (!material || material->render_queue() < min_render_queue ||
+          material->render_queue() > max_render_queue)
+        continue;
+
+      for (const auto& shader_pass : material->passes()) {
+        // Pass name
+        if (!shader_pass || !shader_pass->pipeline ||
+            shader_pass->passName != drawing_settings->passName)
+          continue;
+
+        DrawList::Draw draw;
+        draw.renderable = &renderable;
+        draw.pass = shader_pass.get();
+        draw.material = material;
+        draw.mesh = mesh;
+        draw.submesh = submesh.get();
+        draw.render_queue = material->render_queue();
+        draw.order = renderer->order();
+        draw.depth = depth;
+        draw_list_.Add(draw);
       }
     }
   }
 
   // Sorting by criteria
-  if (drawing_settings->sortingSettings) {
+  draw_list_.Sort(criteria);
+
+  // Encode draws, submesh vertices are addressed through the base vertex.
+  // State equal to the bound state is dropped by the pass.
+  wgpu::RenderPassEncoder encoder = pass->handle();
+  RenderPassState* state = pass->state();
+  const uint64_t issued_count = state->issued_count();
+  const uint64_t skipped_count = state->skipped_count();
+  for (size_t i = 0; i < draw_list_.size(); ++i) {
+    const DrawList::Draw& draw = draw_list_[i];
+    const SubMesh* submesh = draw.submesh;
+    if (!draw.mesh->vertex_buffer() || !draw.mesh->index_buffer() ||
+        uint64_t(submesh->indexStart) + submesh->indexCount >
+            draw.mesh->indices().size())
+      continue;
+
+    state->SetPipeline(draw.pass->pipeline->handle());
+    state->SetStencilReference(draw.pass->stencilRef);
+
+    const auto& bindings = draw.material->bindings();
+    for (uint32_t group = 0; group < bindings.size(); ++group) {
+      const auto& binding = bindings[group];
+      if (binding.bind_group)
+        state->SetBindGroup(group, binding.bind_group->handle(),
+                            binding.offsets.size(), binding.offsets.data());
+    }
+
+    state->SetVertexBuffer(submesh->bindingSlot, draw.mesh->vertex_buffer(), 0,
+                           WGPU_WHOLE_SIZE);
+    state->SetIndexBuffer(draw.mesh->index_buffer(), wgpu::IndexFormat::Uint32,
+                          0, WGPU_WHOLE_SIZE);
+
+    if (draw.pass->pipeline->immediate_size() >= sizeof(DrawImmediates)) {
+      const Renderable* renderable = draw.renderable;
+      const glm::mat4 model_rows =
+          glm::transpose(renderable->relative_transform);
+      DrawImmediates immediates = {};
+      immediates.model_rows[0] = model_rows[0];
+      immediates.model_rows[1] = model_rows[1];
+      immediates.model_rows[2] = model_rows[2];
+      immediates.lod_fade = renderable->lod_fade;
+      immediates.lod_level = renderable->lod_level;
+      encoder.SetImmediates(0, &immediates, sizeof(immediates));
+    }
+
+    encoder.DrawIndexed(submesh->indexCount, 1, submesh->indexStart,
+                        static_cast<int32_t>(submesh->vertexStart), 0);
+    ++draw_calls_;
   }
+
+  state_changes_issued_ += state->issued_count() - issued_count;
+  state_changes_skipped_ += state->skipped_count() - skipped_count;
+}
+
+scoped_refptr<RenderStats> RenderContext::GetStats(URGE_EXCEPTION) {
+  auto stats = Object::Create<RenderStats>();
+  stats->drawCalls = draw_calls_;
+  stats->stateChangesIssued = state_changes_issued_;
+  stats->stateChangesSkipped = state_changes_skipped_;
+  stats->cullCandidates = cull_candidates_;
+  stats->cullMilliseconds = cull_milliseconds_;
+  stats->cullThreads =
+      static_cast<uint32_t>(base::WorkerPool::GetDefault()->concurrency());
+  return stats;
 }
 
 ///
@@ -172,12 +597,16 @@ void Viewport::Render(scoped_refptr<GPUTextureView> render_target,
   auto* gfx = graphics->gfx();
 
   if (!render_process_.is_null()) {
+    // Transform stage
+    world_->UpdateTransforms();
+
     // Prepare for frame
     PrepareFrame(gfx);
 
     // Render context
     auto render_context = Object::Create<RenderContext>(
-        world_.get(), gfx->queue(), render_target, depth_stencil);
+        world_.get(), Object::Create<GPUQueue>(gfx->queue()), render_target,
+        depth_stencil);
 
     // Collected cameras (viewports)
     std::vector<scoped_refptr<Camera>> cameras(world_->cameras_.begin(),
@@ -192,10 +621,25 @@ void Viewport::Render(scoped_refptr<GPUTextureView> render_target,
 }
 
 void Viewport::PrepareFrame(renderer::RenderDevice* gfx) {
-  // Vertex buffer / Index buffer
-  for (auto& renderer : world_->renderers_)
-    if (auto* mesh = renderer->mesh(); mesh)
+  // Bounds of renderers whose mesh data changed, before culling
+  for (auto& entry : world_->renderers_)
+    entry.renderer->UpdateMeshBounds();
+
+  // Vertex buffer / Index buffer, meshes upload only data changed since
+  // their last upload so shared and static meshes are written once
+  for (auto& entry : world_->renderers_) {
+    if (entry.flags & RendererEntry::kBatched)
+      continue;
+
+    if (auto* mesh = entry.renderer->mesh(); mesh)
       mesh->UpdateGPUBuffer(gfx);
+
+    // Any level may be selected during culling
+    if (entry.lod_group)
+      for (const auto& level : entry.lod_group->levels())
+        if (level.mesh)
+          level.mesh->UpdateGPUBuffer(gfx);
+  }
 }
 
 }  // namespace content
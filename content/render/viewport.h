@@ -4,13 +4,18 @@
 
 #pragma once
 
+#include <limits>
+
 #include "content/common/exception.h"
 #include "content/content_config.h"
 #include "content/gpu/gpu_device.h"
 #include "content/gpu/gpu_resource.h"
+#include "content/render/bounds_batch.h"
+#include "content/render/draw_list.h"
 #include "content/scene/camera.h"
 #include "content/scene/renderer.h"
 #include "content/scene/world.h"
+#include "renderer/device/render_device.h"
 
 namespace content {
 
@@ -18,8 +23,28 @@ struct Renderable {
   MeshRenderer* host_node;
   Camera* cast_camera;
   glm::mat4 relative_transform;
+
+  // Mesh of the selected level of detail
+  Mesh* mesh;
+  uint32_t lod_level;
+  float lod_fade;
+};
+
+// Per-draw data written as immediates before each draw of DrawRenderers to
+// pipelines whose layout declares at least this many immediate bytes, other
+// pipelines receive no per-draw data. The camera relative model matrix is
+// stored as its first three rows so the block fits in 64 bytes:
+//   world = vec3(dot(model_rows[0], p), dot(model_rows[1], p),
+//                dot(model_rows[2], p)) with p = vec4(position, 1)
+struct DrawImmediates {
+  glm::vec4 model_rows[3];
+  float lod_fade;
+  uint32_t lod_level;
+  uint32_t padding[2];
 };
 
+static_assert(sizeof(DrawImmediates) == 64);
+
 URGE_BINDING()
 class SortingSettings : public Object {
  public:
@@ -82,6 +107,34 @@ class CullingResults : public Object {
   std::vector<Renderable> visible_renderers_;
 };
 
+// Counters of the culling and of the draws encoded by DrawRenderers during
+// one frame
+URGE_BINDING()
+class RenderStats : public Object {
+ public:
+  URGE_BINDING()
+  uint32_t drawCalls = 0;
+
+  // State changes reaching the encoder and dropped as already bound
+  URGE_BINDING()
+  uint64_t stateChangesIssued = 0;
+
+  URGE_BINDING()
+  uint64_t stateChangesSkipped = 0;
+
+  // Candidates tested by the frustum culling of Cull and CullMany, and the
+  // wall time spent transforming and testing their bounds
+  URGE_BINDING()
+  uint64_t cullCandidates = 0;
+
+  URGE_BINDING()
+  double cullMilliseconds = 0.0;
+
+  // Threads of the pool running the culling, the caller included
+  URGE_BINDING()
+  uint32_t cullThreads = 0;
+};
+
 ///
 /// RenderContext
 ///
@@ -111,6 +164,15 @@ class RenderContext : public Object {
   scoped_refptr<CullingResults> Cull(scoped_refptr<Camera> camera,
                                      URGE_EXCEPTION);
 
+  // Culls the renderers for several cameras in one pass, bounds are loaded
+  // and transformed once and tested against all frustums together.
+  URGE_BINDING()
+  earray<scoped_refptr<CullingResults>> CullMany(
+      earray<scoped_refptr<Camera>> cameras,
+      URGE_EXCEPTION);
+
+  // Encodes the visible draws sorted by |drawing_settings|, draws of
+  // pipelines declaring immediates receive DrawImmediates.
   URGE_BINDING()
   void DrawRenderers(scoped_refptr<GPURenderPassEncoder> pass,
                      scoped_refptr<CullingResults> culling_results,
@@ -118,12 +180,61 @@ class RenderContext : public Object {
                      scoped_refptr<FilteringSettings> filtering_settings,
                      URGE_EXCEPTION);
 
+  URGE_BINDING()
+  scoped_refptr<RenderStats> GetStats(URGE_EXCEPTION);
+
  private:
   World* world_;
 
   scoped_refptr<GPUQueue> queue_;
   scoped_refptr<GPUTextureView> render_target_view_;
   scoped_refptr<GPUTextureView> depth_stencil_view_;
+
+  // Transforms the bounds of the gathered candidates relative to |origin|
+  // and tests them against |frustums|, in parallel chunks.
+  void CullCandidates(const glm::dvec3& origin,
+                      const Frustum* frustums,
+                      uint32_t frustum_count);
+
+  glm::mat4 GetRelativeModel(const RendererEntry& entry,
+                             const glm::dvec3& origin);
+
+  // Fills |visible| for the renderer, false if its level of detail is culled
+  bool SelectLevelOfDetail(Camera* camera,
+                           uint32_t handle,
+                           const glm::mat4& relative_model,
+                           const glm::vec3& center,
+                           const glm::vec3& extent,
+                           CullCache::VisibleRenderer* visible);
+
+  // Occlusion tests |visible| and appends the survivors to |results|
+  void EmitRenderables(Camera* camera,
+                       const glm::mat4& view_projection,
+                       const std::vector<CullCache::VisibleRenderer>& visible,
+                       CullingResults* results);
+
+  // Culling scratch reused by every camera of the frame
+  static constexpr size_t kCullGrainSize = 1024;
+  static constexpr uint32_t kInvalidCullSlot =
+      std::numeric_limits<uint32_t>::max();
+  BoundsBatch cull_bounds_;
+  std::vector<uint32_t> cull_handles_;
+  std::vector<glm::mat4> cull_models_;
+  std::vector<uint32_t> cull_visibility_;
+
+  // Candidate slot by renderer handle and accepting cameras, for CullMany
+  std::vector<uint32_t> cull_slots_;
+  std::vector<uint32_t> cull_view_masks_;
+  std::vector<CullCache::VisibleRenderer> cull_visible_set_;
+
+  DrawList draw_list_;
+
+  // Frame counters, see RenderStats
+  uint32_t draw_calls_;
+  uint64_t state_changes_issued_;
+  uint64_t state_changes_skipped_;
+  uint64_t cull_candidates_;
+  double cull_milliseconds_;
 };
 
 ///
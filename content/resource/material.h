@@ -31,12 +31,20 @@ class Material : public Object {
   Material(const Material&) = delete;
   Material& operator=(const Material&) = delete;
 
+  struct BindData {
+    scoped_refptr<GPUBindGroup> bind_group;
+    std::vector<uint32_t> offsets;
+  };
+
   uint32_t render_queue() { return render_queue_; }
 
   const std::vector<scoped_refptr<ShaderPass>>& passes() const {
     return passes_;
   }
 
+  // Bind groups by group index
+  const std::vector<BindData>& bindings() const { return bindings_; }
+
  public:
   URGE_BINDING()
   static scoped_refptr<Material> New(URGE_EXCEPTION);
@@ -57,11 +65,6 @@ class Material : public Object {
                         URGE_EXCEPTION);
 
  private:
-  struct BindData {
-    scoped_refptr<GPUBindGroup> bind_group;
-    std::vector<uint32_t> offsets;
-  };
-
   uint32_t render_queue_;
   std::vector<scoped_refptr<ShaderPass>> passes_;
   std::vector<BindData> bindings_;
@@ -4,23 +4,161 @@
 
 #include "content/resource/mesh.h"
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
 #include "content/render/graphics.h"
+#include "content/render/simd.h"
 
 namespace content {
 
-Mesh::Mesh(uint32_t vertex_bytes, uint32_t index_count) {
+namespace {
+
+// Bounds of the float3 positions read with |stride| for |vertex_count|
+// vertices from |positions|. Every vertex but the last is loaded as four
+// floats with the fourth lane ignored; for tight 12-byte strides that lane
+// overlaps the next vertex, so only the last vertex, which may end the
+// buffer, is read alone. Four vertices are folded per iteration into two
+// accumulator pairs to keep the min/max chains independent.
+void ScanPositionBounds(const uint8_t* positions,
+                        uint32_t stride,
+                        uint32_t vertex_count,
+                        glm::vec3* bounds_min,
+                        glm::vec3* bounds_max) {
+  simd::Float4 min = simd::Set1(std::numeric_limits<float>::max());
+  simd::Float4 max = simd::Set1(std::numeric_limits<float>::lowest());
+  simd::Float4 min_odd = min;
+  simd::Float4 max_odd = max;
+
+  auto load_position = [](const uint8_t* data) {
+    glm::vec3 position;
+    std::memcpy(&position, data, sizeof(position));
+    return position;
+  };
+  auto load_lanes = [&](uint32_t index) {
+    float lanes[4];
+    std::memcpy(lanes, positions + uint64_t(index) * stride, sizeof(lanes));
+    return simd::Load(lanes);
+  };
+
+  uint32_t i = 0;
+  if (stride >= sizeof(glm::vec3)) {
+    for (; i + 4 < vertex_count; i += 4) {
+      const simd::Float4 p0 = load_lanes(i);
+      const simd::Float4 p1 = load_lanes(i + 1);
+      const simd::Float4 p2 = load_lanes(i + 2);
+      const simd::Float4 p3 = load_lanes(i + 3);
+      min = simd::Min(min, simd::Min(p0, p2));
+      max = simd::Max(max, simd::Max(p0, p2));
+      min_odd = simd::Min(min_odd, simd::Min(p1, p3));
+      max_odd = simd::Max(max_odd, simd::Max(p1, p3));
+    }
+    for (; i + 1 < vertex_count; ++i) {
+      const simd::Float4 position = load_lanes(i);
+      min = simd::Min(min, position);
+      max = simd::Max(max, position);
+    }
+    min = simd::Min(min, min_odd);
+    max = simd::Max(max, max_odd);
+  }
+
+  float lanes_min[4], lanes_max[4];
+  simd::Store(lanes_min, min);
+  simd::Store(lanes_max, max);
+  glm::vec3 result_min(lanes_min[0], lanes_min[1], lanes_min[2]);
+  glm::vec3 result_max(lanes_max[0], lanes_max[1], lanes_max[2]);
+  for (; i < vertex_count; ++i) {
+    const glm::vec3 position = load_position(positions + uint64_t(i) * stride);
+    result_min = glm::min(result_min, position);
+    result_max = glm::max(result_max, position);
+  }
+
+  *bounds_min = result_min;
+  *bounds_max = result_max;
+}
+
+}  // namespace
+
+Mesh::Mesh(uint32_t vertex_bytes, uint32_t index_count)
+    : vertex_stride_(0),
+      position_offset_(0),
+      has_normal_(false),
+      normal_offset_(0),
+      bounds_version_(0),
+      bounds_dirty_(true),
+      vertices_dirty_(true),
+      indices_dirty_(true) {
   vertices_.assign(vertex_bytes, 0);
   indices_.assign(index_count, 0);
 }
 
+const std::vector<Mesh::SubMeshBounds>& Mesh::GetSubMeshBounds() {
+  if (!bounds_dirty_)
+    return submesh_bounds_;
+
+  // Vertices whose position lies completely within the vertex data
+  uint32_t vertex_count = 0;
+  if (has_layout() &&
+      vertices_.size() >= position_offset_ + sizeof(glm::vec3))
+    vertex_count = static_cast<uint32_t>(
+        (vertices_.size() - position_offset_ - sizeof(glm::vec3)) /
+            vertex_stride_ +
+        1);
+
+  submesh_bounds_.resize(mesh_groups_.size());
+  for (size_t i = 0; i < mesh_groups_.size(); ++i) {
+    const SubMesh* submesh = mesh_groups_[i].get();
+    SubMeshBounds& bounds = submesh_bounds_[i];
+    bounds.valid = false;
+    if (!submesh)
+      continue;
+
+    if (submesh->boundsMin && submesh->boundsMax) {
+      bounds.min = submesh->boundsMin->data();
+      bounds.max = submesh->boundsMax->data();
+      bounds.valid = true;
+      continue;
+    }
+
+    if (submesh->vertexStart >= vertex_count || !submesh->vertexCount)
+      continue;
+
+    const uint32_t count =
+        std::min(submesh->vertexCount, vertex_count - submesh->vertexStart);
+    ScanPositionBounds(vertices_.data() + position_offset_ +
+                           uint64_t(submesh->vertexStart) * vertex_stride_,
+                       vertex_stride_, count, &bounds.min, &bounds.max);
+    bounds.valid = true;
+  }
+
+  bounds_dirty_ = false;
+  return submesh_bounds_;
+}
+
+void Mesh::InvalidateBounds() {
+  bounds_dirty_ = true;
+  ++bounds_version_;
+}
+
+void Mesh::MarkVerticesChanged() {
+  vertices_dirty_ = true;
+  InvalidateBounds();
+}
+
+void Mesh::MarkIndicesChanged() {
+  indices_dirty_ = true;
+}
+
 void Mesh::UpdateGPUBuffer(renderer::RenderDevice* gfx) {
+  if (!vertices_dirty_ && !indices_dirty_)
+    return;
+
   const auto& device = gfx->device();
   const auto& queue = gfx->queue();
 
   // --- Vertex buffer ---
-  if (!vertices_.empty()) {
+  if (vertices_dirty_ && !vertices_.empty()) {
     size_t required = vertices_.size();
 
     if (vertex_buffer_ && vertex_buffer_.GetSize() >= required) {
@@ -44,7 +182,7 @@ void Mesh::UpdateGPUBuffer(renderer::RenderDevice* gfx) {
   }
 
   // --- Index buffer ---
-  if (!indices_.empty()) {
+  if (indices_dirty_ && !indices_.empty()) {
     size_t required = indices_.size() * sizeof(uint32_t);
 
     if (index_buffer_ && index_buffer_.GetSize() >= required) {
@@ -64,6 +202,9 @@ void Mesh::UpdateGPUBuffer(renderer::RenderDevice* gfx) {
       }
     }
   }
+
+  vertices_dirty_ = false;
+  indices_dirty_ = false;
 }
 
 scoped_refptr<Mesh> Mesh::New(uint32_t vertex_bytes,
@@ -73,6 +214,7 @@ scoped_refptr<Mesh> Mesh::New(uint32_t vertex_bytes,
 }
 
 epointer Mesh::GetVertices(URGE_EXCEPTION) {
+  MarkVerticesChanged();
   return vertices_.data();
 }
 
@@ -81,6 +223,7 @@ uint32_t Mesh::GetVertexBytesSize(URGE_EXCEPTION) {
 }
 
 epointer Mesh::GetIndices(URGE_EXCEPTION) {
+  MarkIndicesChanged();
   return indices_.data();
 }
 
@@ -91,10 +234,48 @@ uint32_t Mesh::GetIndexCount(URGE_EXCEPTION) {
 void Mesh::SetupSubMeshData(earray<scoped_refptr<SubMesh>> data,
                             URGE_EXCEPTION) {
   mesh_groups_ = data;
+  InvalidateBounds();
 }
 
 earray<scoped_refptr<SubMesh>> Mesh::GetSubMeshes(URGE_EXCEPTION) {
   return mesh_groups_;
 }
 
+URGE_ATTRIBUTE_DEFINE(
+    Mesh,
+    Layout,
+    scoped_refptr<VertexLayout>,
+    {
+      auto layout = Object::Create<VertexLayout>();
+      layout->stride = vertex_stride_;
+      layout->positionOffset = position_offset_;
+      layout->hasNormal = has_normal_;
+      layout->normalOffset = normal_offset_;
+      return layout;
+    },
+    {
+      if (!value) {
+        vertex_stride_ = 0;
+        InvalidateBounds();
+        return;
+      }
+
+      // Attributes must fit in one vertex
+      constexpr uint32_t kVec3Size = sizeof(float) * 3;
+      if (value->stride &&
+          (value->positionOffset + kVec3Size > value->stride ||
+           (value->hasNormal &&
+            value->normalOffset + kVec3Size > value->stride))) {
+        exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                              "invalid vertex layout.");
+        return;
+      }
+
+      vertex_stride_ = value->stride;
+      position_offset_ = value->positionOffset;
+      has_normal_ = value->hasNormal;
+      normal_offset_ = value->normalOffset;
+      InvalidateBounds();
+    });
+
 }  // namespace content
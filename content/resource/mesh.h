@@ -10,6 +10,7 @@
 #include "content/common/vector.h"
 #include "content/content_config.h"
 #include "content/gpu/gpu_resource.h"
+#include "renderer/device/render_device.h"
 
 namespace content {
 
@@ -44,6 +45,25 @@ class SubMesh : public Object {
   estring name;
 };
 
+// Describes where vertex attributes used by the engine live in the vertex
+// data, positions and normals are 3 floats each. Zero stride means the layout
+// is not declared.
+URGE_BINDING()
+class VertexLayout : public Object {
+ public:
+  URGE_BINDING()
+  uint32_t stride = 0;
+
+  URGE_BINDING()
+  uint32_t positionOffset = 0;
+
+  URGE_BINDING()
+  bool hasNormal = false;
+
+  URGE_BINDING()
+  uint32_t normalOffset = 0;
+};
+
 URGE_BINDING()
 class Mesh : public Object {
  public:
@@ -52,6 +72,8 @@ class Mesh : public Object {
   Mesh(const Mesh&) = delete;
   Mesh& operator=(const Mesh&) = delete;
 
+  // Uploads vertex and index data changed since the last upload, buffers
+  // are created on first upload or when the data outgrows them.
   void UpdateGPUBuffer(renderer::RenderDevice* gfx);
 
   wgpu::Buffer& vertex_buffer() { return vertex_buffer_; }
@@ -61,18 +83,53 @@ class Mesh : public Object {
     return mesh_groups_;
   }
 
+  std::vector<uint8_t>& vertices() { return vertices_; }
+  std::vector<uint32_t>& indices() { return indices_; }
+
+  // Declared vertex layout
+  bool has_layout() const { return vertex_stride_ > 0; }
+  uint32_t vertex_stride() const { return vertex_stride_; }
+  uint32_t position_offset() const { return position_offset_; }
+  bool has_normal() const { return has_normal_; }
+  uint32_t normal_offset() const { return normal_offset_; }
+
+  // Local bounds of each submesh. Bounds set on the submesh are used as is,
+  // others are computed from the positions of its vertices in the declared
+  // layout. Cached until vertex data, layout or submeshes change.
+  struct SubMeshBounds {
+    glm::vec3 min;
+    glm::vec3 max;
+    bool valid;
+  };
+  const std::vector<SubMeshBounds>& GetSubMeshBounds();
+
+  // Changes whenever cached bounds are invalidated.
+  uint32_t bounds_version() const { return bounds_version_; }
+
+  // Drops cached bounds without touching GPU data.
+  void InvalidateBounds();
+
+  // Required after native code rewrites vertex or index data, changed data
+  // is uploaded by the next UpdateGPUBuffer.
+  void MarkVerticesChanged();
+  void MarkIndicesChanged();
+
  public:
   URGE_BINDING()
   static scoped_refptr<Mesh> New(uint32_t vertex_bytes,
                                  uint32_t index_count,
                                  URGE_EXCEPTION);
 
+  // Vertex data is writable through the returned pointer, cached bounds are
+  // recomputed on next use and the data is uploaded on next frame.
   URGE_BINDING()
   epointer GetVertices(URGE_EXCEPTION);
 
   URGE_BINDING()
   uint32_t GetVertexBytesSize(URGE_EXCEPTION);
 
+  // Index data is writable through the returned pointer, uploaded on next
+  // frame.
   URGE_BINDING()
   epointer GetIndices(URGE_EXCEPTION);
 
@@ -85,12 +142,28 @@ class Mesh : public Object {
   URGE_BINDING()
   earray<scoped_refptr<SubMesh>> GetSubMeshes(URGE_EXCEPTION);
 
+  URGE_BINDING()
+  URGE_ATTRIBUTE_DECLARE(Layout, scoped_refptr<VertexLayout>);
+
  private:
   std::vector<scoped_refptr<SubMesh>> mesh_groups_;
 
+  uint32_t vertex_stride_;
+  uint32_t position_offset_;
+  bool has_normal_;
+  uint32_t normal_offset_;
+
   std::vector<uint8_t> vertices_;
   std::vector<uint32_t> indices_;
 
+  std::vector<SubMeshBounds> submesh_bounds_;
+  uint32_t bounds_version_;
+  bool bounds_dirty_;
+
+  // Data written since the last upload
+  bool vertices_dirty_;
+  bool indices_dirty_;
+
   wgpu::Buffer vertex_buffer_;
   wgpu::Buffer index_buffer_;
 };
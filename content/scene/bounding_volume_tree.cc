@@ -0,0 +1,253 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/scene/bounding_volume_tree.h"
+
+#include <algorithm>
+
+namespace content {
+
+namespace {
+
+// Enlargement of leaf boxes relative to their size, plus a fixed minimum
+constexpr float kFatBoxRatio = 0.1f;
+constexpr float kFatBoxMargin = 0.05f;
+
+AABB Union(const AABB& a, const AABB& b) {
+  return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+}
+
+float SurfaceArea(const AABB& box) {
+  const glm::vec3 size = box.max - box.min;
+  return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool ContainsBox(const AABB& outer, const AABB& inner) {
+  return glm::all(glm::lessThanEqual(outer.min, inner.min)) &&
+         glm::all(glm::greaterThanEqual(outer.max, inner.max));
+}
+
+AABB Enlarge(const AABB& box) {
+  const glm::vec3 margin =
+      (box.max - box.min) * kFatBoxRatio + glm::vec3(kFatBoxMargin);
+  return AABB(box.min - margin, box.max + margin);
+}
+
+}  // namespace
+
+BoundingVolumeTree::BoundingVolumeTree()
+    : root_(kNullProxy), free_list_(kNullProxy) {}
+
+BoundingVolumeTree::~BoundingVolumeTree() = default;
+
+BoundingVolumeTree::ProxyId BoundingVolumeTree::CreateProxy(
+    const AABB& box,
+    uint32_t user_data) {
+  const ProxyId proxy = AllocateNode();
+  nodes_[proxy].box = Enlarge(box);
+  nodes_[proxy].user_data = user_data;
+  nodes_[proxy].height = 0;
+
+  InsertLeaf(proxy);
+  return proxy;
+}
+
+void BoundingVolumeTree::DestroyProxy(ProxyId proxy) {
+  RemoveLeaf(proxy);
+  FreeNode(proxy);
+}
+
+bool BoundingVolumeTree::MoveProxy(ProxyId proxy, const AABB& box) {
+  if (ContainsBox(nodes_[proxy].box, box))
+    return false;
+
+  RemoveLeaf(proxy);
+  nodes_[proxy].box = Enlarge(box);
+  InsertLeaf(proxy);
+  return true;
+}
+
+BoundingVolumeTree::ProxyId BoundingVolumeTree::AllocateNode() {
+  ProxyId node;
+  if (free_list_ != kNullProxy) {
+    node = free_list_;
+    free_list_ = nodes_[node].parent;
+  } else {
+    node = static_cast<ProxyId>(nodes_.size());
+    nodes_.emplace_back();
+  }
+
+  nodes_[node].parent = kNullProxy;
+  nodes_[node].child1 = kNullProxy;
+  nodes_[node].child2 = kNullProxy;
+  nodes_[node].height = 0;
+  nodes_[node].user_data = 0;
+  return node;
+}
+
+void BoundingVolumeTree::FreeNode(ProxyId node) {
+  nodes_[node].parent = free_list_;
+  nodes_[node].height = -1;
+  free_list_ = node;
+}
+
+void BoundingVolumeTree::InsertLeaf(ProxyId leaf) {
+  if (root_ == kNullProxy) {
+    root_ = leaf;
+    nodes_[leaf].parent = kNullProxy;
+    return;
+  }
+
+  // Descend towards the sibling of least area cost
+  const AABB leaf_box = nodes_[leaf].box;
+  ProxyId index = root_;
+  while (!nodes_[index].IsLeaf()) {
+    const TreeNode& node = nodes_[index];
+    const float area = SurfaceArea(node.box);
+    const float combined_area = SurfaceArea(Union(node.box, leaf_box));
+
+    // Cost of pairing with this node, and the cost pushed down to children
+    const float cost = 2.0f * combined_area;
+    const float inheritance_cost = 2.0f * (combined_area - area);
+
+    auto child_cost = [&](ProxyId child) {
+      const AABB& child_box = nodes_[child].box;
+      const float union_area = SurfaceArea(Union(child_box, leaf_box));
+      if (nodes_[child].IsLeaf())
+        return union_area + inheritance_cost;
+      return union_area - SurfaceArea(child_box) + inheritance_cost;
+    };
+
+    const float cost1 = child_cost(node.child1);
+    const float cost2 = child_cost(node.child2);
+    if (cost < cost1 && cost < cost2)
+      break;
+
+    index = cost1 < cost2 ? node.child1 : node.child2;
+  }
+
+  // Replace sibling by a new parent of both
+  const ProxyId sibling = index;
+  const ProxyId old_parent = nodes_[sibling].parent;
+  const ProxyId new_parent = AllocateNode();
+  nodes_[new_parent].parent = old_parent;
+  nodes_[new_parent].box = Union(leaf_box, nodes_[sibling].box);
+  nodes_[new_parent].height = nodes_[sibling].height + 1;
+  nodes_[new_parent].child1 = sibling;
+  nodes_[new_parent].child2 = leaf;
+  nodes_[sibling].parent = new_parent;
+  nodes_[leaf].parent = new_parent;
+
+  if (old_parent != kNullProxy) {
+    if (nodes_[old_parent].child1 == sibling)
+      nodes_[old_parent].child1 = new_parent;
+    else
+      nodes_[old_parent].child2 = new_parent;
+  } else {
+    root_ = new_parent;
+  }
+
+  RefitAncestors(nodes_[leaf].parent);
+}
+
+void BoundingVolumeTree::RemoveLeaf(ProxyId leaf) {
+  if (leaf == root_) {
+    root_ = kNullProxy;
+    return;
+  }
+
+  // Sibling takes the place of the parent
+  const ProxyId parent = nodes_[leaf].parent;
+  const ProxyId grand_parent = nodes_[parent].parent;
+  const ProxyId sibling = nodes_[parent].child1 == leaf
+                              ? nodes_[parent].child2
+                              : nodes_[parent].child1;
+
+  if (grand_parent != kNullProxy) {
+    if (nodes_[grand_parent].child1 == parent)
+      nodes_[grand_parent].child1 = sibling;
+    else
+      nodes_[grand_parent].child2 = sibling;
+    nodes_[sibling].parent = grand_parent;
+    FreeNode(parent);
+
+    RefitAncestors(grand_parent);
+  } else {
+    root_ = sibling;
+    nodes_[sibling].parent = kNullProxy;
+    FreeNode(parent);
+  }
+}
+
+void BoundingVolumeTree::RefitAncestors(ProxyId node) {
+  while (node != kNullProxy) {
+    node = Balance(node);
+
+    TreeNode& current = nodes_[node];
+    const TreeNode& child1 = nodes_[current.child1];
+    const TreeNode& child2 = nodes_[current.child2];
+    current.height = 1 + std::max(child1.height, child2.height);
+    current.box = Union(child1.box, child2.box);
+
+    node = current.parent;
+  }
+}
+
+BoundingVolumeTree::ProxyId BoundingVolumeTree::Balance(ProxyId a) {
+  TreeNode& node_a = nodes_[a];
+  if (node_a.IsLeaf() || node_a.height < 2)
+    return a;
+
+  const ProxyId b = node_a.child1;
+  const ProxyId c = node_a.child2;
+  const int32_t balance = nodes_[c].height - nodes_[b].height;
+
+  // Rotate the taller child up, its shorter child goes down to |a|
+  auto rotate = [&](ProxyId up, ProxyId other) {
+    TreeNode& node_up = nodes_[up];
+    const ProxyId f = node_up.child1;
+    const ProxyId g = node_up.child2;
+
+    node_up.child1 = a;
+    node_up.parent = node_a.parent;
+    node_a.parent = up;
+
+    if (node_up.parent != kNullProxy) {
+      if (nodes_[node_up.parent].child1 == a)
+        nodes_[node_up.parent].child1 = up;
+      else
+        nodes_[node_up.parent].child2 = up;
+    } else {
+      root_ = up;
+    }
+
+    const bool keep_f = nodes_[f].height > nodes_[g].height;
+    const ProxyId kept = keep_f ? f : g;
+    const ProxyId moved = keep_f ? g : f;
+
+    node_up.child2 = kept;
+    if (node_a.child1 == up)
+      node_a.child1 = moved;
+    else
+      node_a.child2 = moved;
+    nodes_[moved].parent = a;
+
+    node_a.box = Union(nodes_[other].box, nodes_[moved].box);
+    node_a.height =
+        1 + std::max(nodes_[other].height, nodes_[moved].height);
+    node_up.box = Union(node_a.box, nodes_[kept].box);
+    node_up.height = 1 + std::max(node_a.height, nodes_[kept].height);
+
+    return up;
+  };
+
+  if (balance > 1)
+    return rotate(c, b);
+  if (balance < -1)
+    return rotate(b, c);
+
+  return a;
+}
+
+}  // namespace content
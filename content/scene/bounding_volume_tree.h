@@ -0,0 +1,186 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "content/render/frustum.h"
+
+namespace content {
+
+// Dynamic AABB tree over world space bounds. Leaves store enlarged boxes so
+// small movements do not touch the tree, inserted leaves pick the sibling of
+// least surface area cost and ancestors are rebalanced by rotations on the way
+// up, keeping queries logarithmic in the number of proxies.
+class BoundingVolumeTree {
+ public:
+  using ProxyId = int32_t;
+  static constexpr ProxyId kNullProxy = -1;
+
+  BoundingVolumeTree();
+  ~BoundingVolumeTree();
+
+  BoundingVolumeTree(const BoundingVolumeTree&) = delete;
+  BoundingVolumeTree& operator=(const BoundingVolumeTree&) = delete;
+
+  ProxyId CreateProxy(const AABB& box, uint32_t user_data);
+  void DestroyProxy(ProxyId proxy);
+
+  // Reinserts the proxy only if |box| left the enlarged box.
+  bool MoveProxy(ProxyId proxy, const AABB& box);
+
+  uint32_t GetUserData(ProxyId proxy) const { return nodes_[proxy].user_data; }
+  const AABB& GetFatBox(ProxyId proxy) const { return nodes_[proxy].box; }
+
+  // Invokes |callback(user_data)| for every proxy whose enlarged box
+  // intersects |frustum|. Each subtree only tests the planes its parent box
+  // crosses, subtrees fully inside the frustum are accepted without tests.
+  template <typename Functor>
+  void Query(const Frustum& frustum, Functor&& callback) const {
+    if (root_ == kNullProxy)
+      return;
+
+    struct Entry {
+      ProxyId node;
+      uint32_t plane_mask;
+    };
+
+    std::vector<Entry> stack;
+    stack.reserve(64);
+    stack.push_back({root_, Frustum::kAllPlanes});
+    while (!stack.empty()) {
+      const Entry entry = stack.back();
+      stack.pop_back();
+
+      const TreeNode& node = nodes_[entry.node];
+      uint32_t plane_mask = entry.plane_mask;
+      if (plane_mask && !frustum.IntersectsAABB(node.box, &plane_mask))
+        continue;
+
+      if (node.IsLeaf()) {
+        callback(node.user_data);
+      } else {
+        stack.push_back({node.child1, plane_mask});
+        stack.push_back({node.child2, plane_mask});
+      }
+    }
+  }
+
+  // Invokes |callback(user_data)| for every proxy whose enlarged box
+  // overlaps |box|.
+  template <typename Functor>
+  void Query(const AABB& box, Functor&& callback) const {
+    Traverse(
+        [&](const AABB& node_box) {
+          return glm::all(glm::lessThanEqual(node_box.min, box.max)) &&
+                 glm::all(glm::greaterThanEqual(node_box.max, box.min));
+        },
+        callback);
+  }
+
+  // Invokes |callback(user_data, max_distance)| for proxies hit by the ray
+  // in any order, the callback returns the distance the ray is clipped to.
+  template <typename Functor>
+  void RayCast(const glm::vec3& origin,
+               const glm::vec3& direction,
+               float max_distance,
+               Functor&& callback) const {
+    // Axes parallel to the slabs test the origin instead, an origin on a
+    // slab plane would give 0 * inf otherwise
+    constexpr float kParallelEpsilon = 1e-12f;
+    glm::vec3 inv_direction(0.0f);
+    glm::bvec3 parallel;
+    for (int32_t axis = 0; axis < 3; ++axis) {
+      parallel[axis] = std::abs(direction[axis]) < kParallelEpsilon;
+      if (!parallel[axis])
+        inv_direction[axis] = 1.0f / direction[axis];
+    }
+
+    Traverse(
+        [&](const AABB& box) {
+          // Slab test against the enlarged box
+          float enter = 0.0f;
+          float exit = max_distance;
+          for (int32_t axis = 0; axis < 3; ++axis) {
+            if (parallel[axis]) {
+              if (origin[axis] < box.min[axis] || origin[axis] > box.max[axis])
+                return false;
+              continue;
+            }
+
+            float t0 = (box.min[axis] - origin[axis]) * inv_direction[axis];
+            float t1 = (box.max[axis] - origin[axis]) * inv_direction[axis];
+            if (t0 > t1)
+              std::swap(t0, t1);
+            enter = std::max(enter, t0);
+            exit = std::min(exit, t1);
+          }
+
+          return enter <= exit;
+        },
+        [&](uint32_t user_data) {
+          max_distance = callback(user_data, max_distance);
+        });
+  }
+
+  int32_t GetHeight() const {
+    return root_ != kNullProxy ? nodes_[root_].height : 0;
+  }
+
+ private:
+  struct TreeNode {
+    AABB box;
+    // Parent link, next free node while in free list
+    ProxyId parent;
+    ProxyId child1;
+    ProxyId child2;
+    // Leaf is zero, free node is -1
+    int32_t height;
+    uint32_t user_data;
+
+    bool IsLeaf() const { return child1 == kNullProxy; }
+  };
+
+  template <typename Test, typename Functor>
+  void Traverse(Test&& test, Functor&& callback) const {
+    if (root_ == kNullProxy)
+      return;
+
+    std::vector<ProxyId> stack;
+    stack.reserve(64);
+    stack.push_back(root_);
+    while (!stack.empty()) {
+      const TreeNode& node = nodes_[stack.back()];
+      stack.pop_back();
+
+      if (!test(node.box))
+        continue;
+
+      if (node.IsLeaf()) {
+        callback(node.user_data);
+      } else {
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+      }
+    }
+  }
+
+  ProxyId AllocateNode();
+  void FreeNode(ProxyId node);
+
+  void InsertLeaf(ProxyId leaf);
+  void RemoveLeaf(ProxyId leaf);
+  ProxyId Balance(ProxyId node);
+  void RefitAncestors(ProxyId node);
+
+  std::vector<TreeNode> nodes_;
+  ProxyId root_;
+  ProxyId free_list_;
+};
+
+}  // namespace content
@@ -17,6 +17,8 @@ namespace content {
 Camera::Camera()
     : Node(),
       projection_dirty_(true),
+      registry_handle_(World::kInvalidCameraHandle),
+      occlusion_culling_(false),
       culling_mask_(std::numeric_limits<uint64_t>::max()),
       near_(0.1f),
       far_(2000.f) {}
@@ -35,6 +37,22 @@ glm::mat4x4 Camera::GetViewProjection() {
   return GetProjectionMatrix() * view;
 }
 
+OcclusionBuffer* Camera::GetOcclusionBuffer() {
+  if (!occlusion_buffer_)
+    occlusion_buffer_ = std::make_unique<OcclusionBuffer>();
+  return occlusion_buffer_.get();
+}
+
+glm::dvec3 Camera::GetWorldPosition() {
+  return glm::dvec3(GetModelMatrix()[3]);
+}
+
+glm::mat4x4 Camera::GetRelativeViewProjection() {
+  glm::dmat4x4 rotation = GetModelMatrix();
+  rotation[3] = glm::dvec4(0.0, 0.0, 0.0, 1.0);
+  return GetProjectionMatrix() * glm::affineInverse(glm::mat4(rotation));
+}
+
 URGE_ATTRIBUTE_DEFINE(
     Camera,
     CullingMask,
@@ -62,12 +80,33 @@ URGE_ATTRIBUTE_DEFINE(
       NotifyProjectionChange();
     });
 
+URGE_ATTRIBUTE_DEFINE(
+    Camera,
+    OcclusionCulling,
+    bool,
+    { return occlusion_culling_; },
+    {
+      occlusion_culling_ = value;
+      if (!value)
+        occlusion_buffer_.reset();
+    });
+
+void Camera::CopyCameraState(const Camera& source) {
+  // Occlusion buffer is created on first use by the copy
+  occlusion_culling_ = source.occlusion_culling_;
+  culling_mask_ = source.culling_mask_;
+  near_ = source.near_;
+  far_ = source.far_;
+  NotifyProjectionChange();
+}
+
 void Camera::OnEnterWorld(World* new_world) {
-  new_world->RegisterCamera(this);
+  registry_handle_ = new_world->RegisterCamera(this);
 }
 
 void Camera::OnLeaveWorld(World* old_world) {
-  old_world->UnregisterCamera(this);
+  old_world->UnregisterCamera(registry_handle_);
+  registry_handle_ = World::kInvalidCameraHandle;
 }
 
 ///
@@ -105,6 +144,14 @@ glm::mat4x4 PerspectiveCamera::GetProjection() {
   return glm::perspective<float>(fovy_, aspect_, near_plane(), far_plane());
 }
 
+scoped_refptr<Node> PerspectiveCamera::CreateCopy() {
+  auto copy = Object::Create<PerspectiveCamera>();
+  copy->CopyCameraState(*this);
+  copy->fovy_ = fovy_;
+  copy->aspect_ = aspect_;
+  return copy;
+}
+
 ///
 /// OrthographicCamera
 ///
@@ -162,4 +209,14 @@ glm::mat4x4 OrthographicCamera::GetProjection() {
                            far_plane());
 }
 
+scoped_refptr<Node> OrthographicCamera::CreateCopy() {
+  auto copy = Object::Create<OrthographicCamera>();
+  copy->CopyCameraState(*this);
+  copy->left_ = left_;
+  copy->right_ = right_;
+  copy->bottom_ = bottom_;
+  copy->top_ = top_;
+  return copy;
+}
+
 }  // namespace content
@@ -4,7 +4,12 @@
 
 #pragma once
 
+#include <memory>
+
+#include "content/render/cull_cache.h"
+#include "content/render/occlusion_buffer.h"
 #include "content/scene/node.h"
+#include "content/scene/world.h"
 
 namespace content {
 
@@ -20,10 +25,22 @@ class Camera : public Node {
   const glm::mat4x4& GetProjectionMatrix();
   glm::mat4x4 GetViewProjection();
 
+  // Camera position from world hierarchy, origin of camera-relative space.
+  glm::dvec3 GetWorldPosition();
+
+  // View projection centered at camera position (rotation-only view).
+  glm::mat4x4 GetRelativeViewProjection();
+
   uint64_t culling_mask() const { return culling_mask_; }
   float near_plane() const { return near_; }
   float far_plane() const { return far_; }
 
+  // Visibility of the last cull through this camera.
+  CullCache& cull_cache() { return cull_cache_; }
+
+  bool occlusion_culling() const { return occlusion_culling_; }
+  OcclusionBuffer* GetOcclusionBuffer();
+
  public:
   URGE_BINDING()
   URGE_ATTRIBUTE_DECLARE(CullingMask, uint64_t);
@@ -34,10 +51,18 @@ class Camera : public Node {
   URGE_BINDING()
   URGE_ATTRIBUTE_DECLARE(Far, float);
 
+  // Tests renderers passing the frustum against a CPU depth buffer of the
+  // visible occluders before they are reported as visible.
+  URGE_BINDING()
+  URGE_ATTRIBUTE_DECLARE(OcclusionCulling, bool);
+
  protected:
   virtual glm::mat4x4 GetProjection() = 0;
   void NotifyProjectionChange() { projection_dirty_ = true; }
 
+  // Copies camera settings of |source| for node copies.
+  void CopyCameraState(const Camera& source);
+
   void OnEnterWorld(World* new_world) override;
   void OnLeaveWorld(World* old_world) override;
 
@@ -45,6 +70,12 @@ class Camera : public Node {
   glm::mat4x4 projection_;
   bool projection_dirty_;
 
+  World::CameraHandle registry_handle_;
+  CullCache cull_cache_;
+
+  bool occlusion_culling_;
+  std::unique_ptr<OcclusionBuffer> occlusion_buffer_;
+
   uint64_t culling_mask_;
   float near_;
   float far_;
@@ -70,6 +101,7 @@ class PerspectiveCamera : public Camera {
 
  private:
   glm::mat4x4 GetProjection() override;
+  scoped_refptr<Node> CreateCopy() override;
 
   float fovy_;
   float aspect_;
@@ -101,6 +133,7 @@ class OrthographicCamera : public Camera {
 
  private:
   glm::mat4x4 GetProjection() override;
+  scoped_refptr<Node> CreateCopy() override;
 
   float left_;
   float right_;
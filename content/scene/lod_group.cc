@@ -0,0 +1,96 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/scene/lod_group.h"
+
+#include <algorithm>
+
+namespace content {
+
+// static
+scoped_refptr<LODGroup> LODGroup::New(URGE_EXCEPTION) {
+  return Object::Create<LODGroup>();
+}
+
+LODGroup::LODGroup() : hysteresis_(0.1f) {}
+
+uint32_t LODGroup::SelectLevel(float screen_height,
+                               uint32_t previous_level) const {
+  const uint32_t count = static_cast<uint32_t>(levels_.size());
+  if (!count)
+    return 0;
+
+  uint32_t level = 0;
+  while (level < count && screen_height < levels_[level].screen_height)
+    ++level;
+
+  if (previous_level > count || level == previous_level)
+    return level;
+
+  // Keep the previous level until the crossed threshold is left by the
+  // hysteresis band
+  if (level > previous_level) {
+    const float threshold = levels_[previous_level].screen_height;
+    if (screen_height >= threshold * (1.0f - hysteresis_))
+      return previous_level;
+  } else {
+    const float threshold = levels_[previous_level - 1].screen_height;
+    if (screen_height < threshold * (1.0f + hysteresis_))
+      return previous_level;
+  }
+
+  return level;
+}
+
+float LODGroup::GetFade(float screen_height, uint32_t level) const {
+  if (level >= levels_.size() || hysteresis_ <= 0.0f)
+    return 1.0f;
+
+  const float threshold = levels_[level].screen_height;
+  const float band_start = threshold * (1.0f - hysteresis_);
+  const float band_end = threshold * (1.0f + hysteresis_);
+  return std::clamp((screen_height - band_start) / (band_end - band_start),
+                    0.0f, 1.0f);
+}
+
+void LODGroup::SetupLevels(earray<scoped_refptr<LODLevel>> levels,
+                           URGE_EXCEPTION) {
+  std::vector<Level> new_levels;
+  new_levels.reserve(levels.size());
+  for (const auto& it : levels) {
+    if (!it || it->screenRelativeHeight <= 0.0f ||
+        it->screenRelativeHeight > 1.0f ||
+        (!new_levels.empty() &&
+         it->screenRelativeHeight >= new_levels.back().screen_height)) {
+      exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                            "invalid lod levels.");
+      return;
+    }
+
+    new_levels.push_back({it->mesh, it->screenRelativeHeight});
+  }
+
+  levels_ = std::move(new_levels);
+}
+
+earray<scoped_refptr<LODLevel>> LODGroup::GetLevels(URGE_EXCEPTION) {
+  earray<scoped_refptr<LODLevel>> levels;
+  for (const auto& it : levels_) {
+    auto level = Object::Create<LODLevel>();
+    level->mesh = it.mesh;
+    level->screenRelativeHeight = it.screen_height;
+    levels.push_back(level);
+  }
+
+  return levels;
+}
+
+URGE_ATTRIBUTE_DEFINE(
+    LODGroup,
+    Hysteresis,
+    float,
+    { return hysteresis_; },
+    { hysteresis_ = std::clamp(value, 0.0f, 0.5f); });
+
+}  // namespace content
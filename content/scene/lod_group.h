@@ -0,0 +1,75 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <vector>
+
+#include "content/content_config.h"
+#include "content/resource/mesh.h"
+
+namespace content {
+
+URGE_BINDING()
+class LODLevel : public Object {
+ public:
+  // Null mesh draws the mesh of the renderer.
+  URGE_BINDING()
+  scoped_refptr<Mesh> mesh = nullptr;
+
+  // Smallest height of the renderer bounds relative to the screen height
+  // this level is drawn at.
+  URGE_BINDING()
+  float screenRelativeHeight = 0.0f;
+};
+
+// Level of detail selection of renderers sharing the group. Levels are
+// ordered from finest to coarsest with decreasing screen heights, renderers
+// smaller than the last level are culled, groups without levels always draw
+// the renderer mesh. Changing levels requires the height to cross the
+// threshold by the hysteresis fraction, the fade factor reports the progress
+// through that band for cross-fading in shaders.
+URGE_BINDING()
+class LODGroup : public Object {
+ public:
+  struct Level {
+    scoped_refptr<Mesh> mesh;
+    float screen_height;
+  };
+
+  LODGroup();
+
+  LODGroup(const LODGroup&) = delete;
+  LODGroup& operator=(const LODGroup&) = delete;
+
+  const std::vector<Level>& levels() const { return levels_; }
+
+  // Level drawn at |screen_height| coming from |previous_level|, level count
+  // if culled. Previous levels beyond the level count are unknown. Zero for
+  // groups without levels, which never cull.
+  uint32_t SelectLevel(float screen_height, uint32_t previous_level) const;
+
+  // Fade of |level| at |screen_height|, one outside of the band below the
+  // threshold of the level, falls to zero at its lower end.
+  float GetFade(float screen_height, uint32_t level) const;
+
+ public:
+  URGE_BINDING()
+  static scoped_refptr<LODGroup> New(URGE_EXCEPTION);
+
+  URGE_BINDING()
+  void SetupLevels(earray<scoped_refptr<LODLevel>> levels, URGE_EXCEPTION);
+
+  URGE_BINDING()
+  earray<scoped_refptr<LODLevel>> GetLevels(URGE_EXCEPTION);
+
+  URGE_BINDING()
+  URGE_ATTRIBUTE_DECLARE(Hysteresis, float);
+
+ private:
+  std::vector<Level> levels_;
+  float hysteresis_;
+};
+
+}  // namespace content
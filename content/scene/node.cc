@@ -5,8 +5,11 @@
 #include "content/scene/node.h"
 
 #include <algorithm>
+#include <limits>
 #include <stack>
 
+#include "content/scene/world.h"
+
 namespace content {
 
 ///
@@ -21,13 +24,20 @@ scoped_refptr<Node> Node::New(URGE_EXCEPTION) {
 Node::Node()
     : transform_(Object::Create<Transform>()),
       parent_(nullptr),
+      index_in_parent_(0),
+      sibling_serial_(0),
+      next_child_serial_(0),
+      children_unsorted_(false),
       active_(true),
       order_(0),
       layer_(0),
+      static_(false),
       world_(nullptr),
+      name_index_slot_(0),
+      child_index_slot_(0),
       root_node_(false),
       in_world_(false),
-      transform_dirty_(true) {
+      transform_handle_(TransformHierarchy::kInvalidHandle) {
   auto transform_handler =
       base::BindRepeating(&Node::TransformChange, base::Unretained(this));
   transform_->set_change_handler(transform_handler);
@@ -39,17 +49,21 @@ Node::~Node() {
   //  2. When node detached from parent, we dont need to detach again.
 }
 
-const glm::dmat4x4& Node::GetModelMatrix(const glm::dvec3& base_position) {
-  if (transform_dirty_ || position_offset_ != base_position) {
-    position_offset_ = base_position;
-    transform_dirty_ = false;
+glm::dmat4x4 Node::GetModelMatrix() {
+  if (transform_handle_ != TransformHierarchy::kInvalidHandle)
+    return world_->transform_hierarchy()->GetWorldMatrix(transform_handle_);
 
-    model_ = transform_->GetModelMatrix(base_position);
-    if (parent_)
-      model_ = parent_->GetModelMatrix(base_position) * model_;
-  }
+  // Detached node: resolve through parents
+  glm::dmat4x4 model = transform_->GetModelMatrix();
+  if (parent_)
+    model = parent_->GetModelMatrix() * model;
+  return model;
+}
 
-  return model_;
+glm::mat4 Node::GetRelativeMatrix(const glm::dvec3& origin) {
+  glm::dmat4x4 model = GetModelMatrix();
+  model[3] -= glm::dvec4(origin, 0.0);
+  return glm::mat4(model);
 }
 
 void Node::SetupWorld(World* new_world, World* old_world) {
@@ -57,11 +71,17 @@ void Node::SetupWorld(World* new_world, World* old_world) {
     return;
 
   ForEachNode([&](Node* node) {
-    if (old_world)
+    if (old_world) {
       node->LeaveWorld(old_world);
-    if (new_world)
-      node->EnterWorld(new_world);
+      node->DetachTransform(old_world);
+      old_world->UnindexNode(node);
+    }
     node->world_ = new_world;
+    if (new_world) {
+      new_world->IndexNode(node);
+      node->AttachTransform(new_world);
+      node->EnterWorld(new_world);
+    }
     return false;
   });
 }
@@ -70,27 +90,31 @@ void Node::ResetParent(Node* parent) {
   if (parent_ == parent)
     return;
 
+  // Old parent may hold the last reference
+  scoped_refptr<Node> self(this);
+
   // Remove from old parent's children
-  if (parent_) {
-    auto& old_children = parent_->children_;
-    auto it =
-        std::find_if(old_children.begin(), old_children.end(),
-                     [this](const auto& ref) { return ref.get() == this; });
-    if (it != old_children.end())
-      old_children.erase(it);
-  }
+  if (parent_)
+    parent_->RemoveChild(this);
 
-  // Set raw reference
+  // Set raw reference, name index is keyed by parent
+  if (world_)
+    world_->UnindexNode(this);
   parent_ = parent;
-
-  // Add to new parent's children and resort
-  if (parent) {
-    parent->children_.push_back(scoped_refptr<Node>(this));
-    parent->ResortChildren(this);
+  if (world_)
+    world_->IndexNode(this);
+
+  // Add to new parent's children
+  if (parent)
+    parent->AddChild(this);
+
+  // Relink hierarchy storage
+  if (transform_handle_ != TransformHierarchy::kInvalidHandle) {
+    const bool same_world = parent && parent->world_ == world_;
+    world_->transform_hierarchy()->SetParent(
+        transform_handle_, same_world ? parent->transform_handle_
+                                      : TransformHierarchy::kInvalidHandle);
   }
-
-  // Transform notification
-  TransformChange();
 }
 
 URGE_ATTRIBUTE_DEFINE(
@@ -141,7 +165,6 @@ URGE_ATTRIBUTE_DEFINE(
       }
 
       active_ = value;
-      TransformChange();
     });
 
 URGE_ATTRIBUTE_DEFINE(
@@ -150,9 +173,12 @@ URGE_ATTRIBUTE_DEFINE(
     int64_t,
     { return order_; },
     {
+      if (order_ == value)
+        return;
+
       order_ = value;
       if (parent_)
-        parent_->ResortChildren(this);
+        parent_->children_unsorted_ = true;
     });
 
 URGE_ATTRIBUTE_DEFINE(
@@ -160,14 +186,41 @@ URGE_ATTRIBUTE_DEFINE(
     Layer,
     uint32_t,
     { return layer_; },
-    { layer_ = value; });
+    {
+      layer_ = value;
+      OnLayerChange();
+    });
 
 URGE_ATTRIBUTE_DEFINE(
     Node,
     Name,
     std::string,
     { return name_; },
-    { name_ = value; });
+    {
+      if (name_ == value)
+        return;
+
+      if (world_)
+        world_->UnindexNode(this);
+      name_ = value;
+      if (world_)
+        world_->IndexNode(this);
+    });
+
+URGE_ATTRIBUTE_DEFINE(
+    Node,
+    Static,
+    bool,
+    { return static_; },
+    {
+      if (static_ == value)
+        return;
+
+      static_ = value;
+      if (transform_handle_ != TransformHierarchy::kInvalidHandle)
+        world_->transform_hierarchy()->SetFrozen(transform_handle_, static_);
+      OnStaticChange();
+    });
 
 scoped_refptr<Transform> Node::GetTransform(URGE_EXCEPTION) {
   return transform_;
@@ -178,9 +231,90 @@ uint32_t Node::GetChildrenCount(URGE_EXCEPTION) {
 }
 
 scoped_refptr<Node> Node::GetChildAt(uint32_t index, URGE_EXCEPTION) {
-  if (index >= 0 && index < children_.size())
-    return children_[index];
-  return nullptr;
+  if (index >= children_.size())
+    return nullptr;
+
+  SortChildren();
+  return children_[index];
+}
+
+scoped_refptr<Node> Node::FindChild(estring path, URGE_EXCEPTION) {
+  Node* current = this;
+  size_t begin = 0;
+  while (current && begin <= path.size()) {
+    size_t end = path.find('/', begin);
+    if (end == std::string::npos)
+      end = path.size();
+
+    // Empty segments are skipped
+    if (end > begin) {
+      const std::string segment = path.substr(begin, end - begin);
+      if (world_) {
+        current = world_->FindChildByName(current, segment);
+      } else {
+        auto it = std::find_if(
+            current->children_.begin(), current->children_.end(),
+            [&](const auto& child) { return child->name_ == segment; });
+        current = it != current->children_.end() ? it->get() : nullptr;
+      }
+    }
+
+    begin = end + 1;
+  }
+
+  return current != this ? current : nullptr;
+}
+
+earray<scoped_refptr<Node>> Node::Instantiate(uint32_t count,
+                                              scoped_refptr<Node> parent,
+                                              URGE_EXCEPTION) {
+  // Flatten the source once, parents first and children in sibling order
+  constexpr uint32_t kNoParent = std::numeric_limits<uint32_t>::max();
+  std::vector<std::pair<Node*, uint32_t>> sources = {{this, kNoParent}};
+  size_t renderer_count = 0;
+  for (size_t i = 0; i < sources.size(); ++i) {
+    Node* node = sources[i].first;
+    if (node->AsMeshRenderer())
+      ++renderer_count;
+
+    node->SortChildren();
+    for (auto& child : node->children_)
+      sources.emplace_back(child.get(), static_cast<uint32_t>(i));
+  }
+
+  // Copies are built detached, linking only touches local state. Objects of
+  // copies entering a world are allocated from its pools.
+  base::ObjectPoolScope pool_scope(
+      parent && parent->world_ ? parent->world_->object_pools() : nullptr);
+  earray<scoped_refptr<Node>> instances;
+  instances.reserve(count);
+  std::vector<scoped_refptr<Node>> copies(sources.size());
+  for (uint32_t instance = 0; instance < count; ++instance) {
+    for (size_t i = 0; i < sources.size(); ++i) {
+      Node* source = sources[i].first;
+      copies[i] = source->CreateCopy();
+      copies[i]->CopyNodeState(source);
+      if (i > 0)
+        copies[i]->ResetParent(copies[sources[i].second].get());
+    }
+
+    instances.push_back(copies.front());
+  }
+
+  if (parent) {
+    if (parent->world_)
+      parent->world_->ReserveNodes(sources.size() * count,
+                                   renderer_count * count);
+
+    for (auto& it : instances)
+      it->Put_Parent(parent, exception_state);
+  }
+
+  return instances;
+}
+
+scoped_refptr<Node> Node::CreateCopy() {
+  return Object::Create<Node>();
 }
 
 void Node::ForEachNode(std::function<bool(Node*)> iter) {
@@ -191,7 +325,7 @@ void Node::ForEachNode(std::function<bool(Node*)> iter) {
     Node* node = stack.top();
     stack.pop();
 
-    for (auto& it : children_)
+    for (auto& it : node->children_)
       stack.push(it.get());
 
     if (iter(node))
@@ -213,49 +347,82 @@ void Node::LeaveWorld(World* world) {
   }
 }
 
-void Node::ResortChildren(Node* target) {
-  if (children_.size() <= 1)
-    return;
+void Node::AddChild(Node* child) {
+  child->index_in_parent_ = static_cast<uint32_t>(children_.size());
+  child->sibling_serial_ = next_child_serial_++;
 
-  if (!target) {
-    // Full sort: sort all children by order_ ascending
-    std::sort(
-        children_.begin(), children_.end(),
-        [](const auto& a, const auto& b) { return a->order_ < b->order_; });
-    return;
+  // Appending keeps the order unless the child sorts before the last one
+  if (!children_.empty() && child->order_ < children_.back()->order_)
+    children_unsorted_ = true;
+
+  children_.push_back(scoped_refptr<Node>(child));
+}
+
+void Node::RemoveChild(Node* child) {
+  const uint32_t index = child->index_in_parent_;
+  if (index + 1 < children_.size()) {
+    children_[index] = std::move(children_.back());
+    children_[index]->index_in_parent_ = index;
+    children_unsorted_ = true;
   }
 
-  // Bubble target to its correct position by swapping with neighbors
-  auto it =
-      std::find_if(children_.begin(), children_.end(),
-                   [target](const auto& ref) { return ref.get() == target; });
-  if (it == children_.end())
+  children_.pop_back();
+}
+
+void Node::SortChildren() {
+  if (!children_unsorted_)
     return;
 
-  size_t idx = std::distance(children_.begin(), it);
+  // Ties are kept in insertion order
+  std::sort(children_.begin(), children_.end(),
+            [](const auto& a, const auto& b) {
+              if (a->order_ != b->order_)
+                return a->order_ < b->order_;
+              return a->sibling_serial_ < b->sibling_serial_;
+            });
+
+  for (size_t i = 0; i < children_.size(); ++i)
+    children_[i]->index_in_parent_ = static_cast<uint32_t>(i);
+  children_unsorted_ = false;
+}
 
-  // Bubble left while target->order_ < left neighbor's order_
-  while (idx > 0 && target->order_ < children_[idx - 1]->order_) {
-    std::swap(children_[idx - 1], children_[idx]);
-    --idx;
-  }
+void Node::CopyNodeState(Node* source) {
+  active_ = source->active_;
+  order_ = source->order_;
+  layer_ = source->layer_;
+  name_ = source->name_;
+  static_ = source->static_;
 
-  // Bubble right while target->order_ > right neighbor's order_
-  while (idx + 1 < children_.size() &&
-         target->order_ > children_[idx + 1]->order_) {
-    std::swap(children_[idx], children_[idx + 1]);
-    ++idx;
-  }
+  Transform* transform = source->transform();
+  transform_->SetData(transform->position(), transform->quaternion(),
+                      transform->scale());
 }
 
 void Node::TransformChange() {
-  ForEachNode([](Node* node) {
-    if (node->active_) {
-      node->transform_dirty_ = true;
-      return false;
-    }
-    return true;
-  });
+  if (transform_handle_ != TransformHierarchy::kInvalidHandle)
+    world_->transform_hierarchy()->SetLocal(
+        transform_handle_, transform_->position(), transform_->quaternion(),
+        transform_->scale());
+}
+
+void Node::AttachTransform(World* world) {
+  auto* hierarchy = world->transform_hierarchy();
+  transform_handle_ = hierarchy->Allocate();
+
+  // Parent has been attached before its children
+  if (parent_ && parent_->world_ == world)
+    hierarchy->SetParent(transform_handle_, parent_->transform_handle_);
+  TransformChange();
+
+  if (static_)
+    hierarchy->SetFrozen(transform_handle_, true);
+}
+
+void Node::DetachTransform(World* world) {
+  if (transform_handle_ != TransformHierarchy::kInvalidHandle) {
+    world->transform_hierarchy()->Release(transform_handle_);
+    transform_handle_ = TransformHierarchy::kInvalidHandle;
+  }
 }
 
 }  // namespace content
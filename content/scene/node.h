@@ -7,16 +7,21 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/object_pool.h"
 #include "base/memory/ref_counted.h"
 #include "content/content_config.h"
 #include "content/scene/transform.h"
+#include "content/scene/transform_hierarchy.h"
 
 namespace content {
 
+class MeshRenderer;
 class World;
 
 URGE_BINDING()
 class Node : public Object {
+  BASE_POOL_ALLOCATED(Node);
+
  public:
   Node();
   ~Node() override;
@@ -24,14 +29,28 @@ class Node : public Object {
   Node(const Node&) = delete;
   Node& operator=(const Node&) = delete;
 
-  const glm::dmat4x4& GetModelMatrix(const glm::dvec3& base_position);
+  glm::dmat4x4 GetModelMatrix();
+
+  // Model matrix relative to |origin|, derived from the cached absolute world
+  // matrix with a single translation subtract, shared by all cameras.
+  glm::mat4 GetRelativeMatrix(const glm::dvec3& origin);
   void SetupWorld(World* new_world, World* old_world);
   void ResetParent(Node* parent);
 
   Transform* transform() { return transform_.get(); }
 
   World* world() { return world_; }
+  Node* parent() const { return parent_; }
+  const std::string& name() const { return name_; }
   uint32_t layer() const { return layer_; }
+  bool is_static() const { return static_; }
+  bool is_active() const { return active_; }
+  int64_t order() const { return order_; }
+
+  virtual MeshRenderer* AsMeshRenderer() { return nullptr; }
+  TransformHierarchy::Handle transform_handle() const {
+    return transform_handle_;
+  }
   bool& root() { return root_node_; }
 
  public:
@@ -53,6 +72,11 @@ class Node : public Object {
   URGE_BINDING()
   URGE_ATTRIBUTE_DECLARE(Name, std::string);
 
+  // Static nodes keep the world matrix of the first update after being
+  // marked, later transform changes apply once the flag is cleared.
+  URGE_BINDING()
+  URGE_ATTRIBUTE_DECLARE(Static, bool);
+
   URGE_BINDING()
   scoped_refptr<Transform> GetTransform(URGE_EXCEPTION);
 
@@ -62,34 +86,70 @@ class Node : public Object {
   URGE_BINDING()
   scoped_refptr<Node> GetChildAt(uint32_t index, URGE_EXCEPTION);
 
+  // Resolves a '/' separated path of names below this node. Lookups use the
+  // world name index, one hash probe per path segment.
+  URGE_BINDING()
+  scoped_refptr<Node> FindChild(estring path, URGE_EXCEPTION);
+
+  // Deep copies this subtree |count| times and attaches the copies under
+  // |parent| (optional). Copies share meshes and materials with the source,
+  // the storage of their world components is reserved once for all copies.
+  URGE_BINDING()
+  earray<scoped_refptr<Node>> Instantiate(uint32_t count,
+                                          scoped_refptr<Node> parent,
+                                          URGE_EXCEPTION);
+
  protected:
+  // Detached node of the same type with type specific state copied, common
+  // node state is copied by the caller. Each subclass overrides it.
+  virtual scoped_refptr<Node> CreateCopy();
+
   virtual void OnEnterWorld(World* new_world) {}
 
   virtual void OnLeaveWorld(World* old_world) {}
 
+  virtual void OnLayerChange() {}
+
+  virtual void OnStaticChange() {}
+
  private:
+  friend class World;
+
   void ForEachNode(std::function<bool(Node*)> iter);
   void EnterWorld(World* world);
   void LeaveWorld(World* world);
-  void ResortChildren(Node* target = nullptr);
+  void AddChild(Node* child);
+  void RemoveChild(Node* child);
+  void SortChildren();
+  void CopyNodeState(Node* source);
   void TransformChange();
+  void AttachTransform(World* world);
+  void DetachTransform(World* world);
 
   scoped_refptr<Transform> transform_;
 
+  // Children are appended and swap-removed in constant time, order is
+  // restored lazily on indexed access.
   Node* parent_;
   std::vector<scoped_refptr<Node>> children_;
+  uint32_t index_in_parent_;
+  uint64_t sibling_serial_;
+  uint64_t next_child_serial_;
+  bool children_unsorted_;
 
   bool active_;
   int64_t order_;
   uint32_t layer_;
   std::string name_;
-  glm::dmat4x4 model_;
+  bool static_;
 
   World* world_;
+  // Positions in world name index buckets
+  uint32_t name_index_slot_;
+  uint32_t child_index_slot_;
   bool root_node_;
   bool in_world_;
-  bool transform_dirty_;
-  glm::dvec3 position_offset_;
+  TransformHierarchy::Handle transform_handle_;
 };
 
 }  // namespace content
@@ -14,7 +14,11 @@ scoped_refptr<MeshRenderer> MeshRenderer::New(URGE_EXCEPTION) {
   return Object::Create<MeshRenderer>();
 }
 
-MeshRenderer::MeshRenderer() {}
+MeshRenderer::MeshRenderer()
+    : occluder_(false),
+      mesh_bounds_version_(0),
+      registry_handle_(World::kInvalidRendererHandle),
+      static_batch_(World::kInvalidStaticBatchHandle) {}
 
 MeshRenderer::~MeshRenderer() {}
 
@@ -23,7 +27,32 @@ URGE_ATTRIBUTE_DEFINE(
     Mesh,
     scoped_refptr<Mesh>,
     { return mesh_; },
-    { mesh_ = value; });
+    {
+      InvalidateStaticBatch();
+      mesh_ = value;
+      UpdateBounds();
+    });
+
+URGE_ATTRIBUTE_DEFINE(
+    MeshRenderer,
+    LODGroup,
+    scoped_refptr<LODGroup>,
+    { return lod_group_; },
+    {
+      InvalidateStaticBatch();
+      lod_group_ = value;
+      SyncRegistryEntry();
+    });
+
+URGE_ATTRIBUTE_DEFINE(
+    MeshRenderer,
+    Occluder,
+    bool,
+    { return occluder_; },
+    {
+      occluder_ = value;
+      SyncRegistryEntry();
+    });
 
 scoped_refptr<Material> MeshRenderer::GetMaterialAtSlot(uint32_t slot,
                                                         URGE_EXCEPTION) {
@@ -38,25 +67,44 @@ void MeshRenderer::SetMaterialAtSlot(uint32_t slot,
   if (slot >= materials_.size())
     materials_.resize(slot + 1);
 
-  if (slot >= 0)
+  if (slot >= 0) {
+    InvalidateStaticBatch();
     materials_[slot] = material;
+  }
 }
 
 void MeshRenderer::ComputeAABB(URGE_EXCEPTION) {
+  // Submesh objects may have been edited in place
+  if (mesh_)
+    mesh_->InvalidateBounds();
+  UpdateBounds();
+}
+
+Mesh* MeshRenderer::GetLevelMesh(uint32_t level) {
+  if (lod_group_ && level < lod_group_->levels().size())
+    if (Mesh* level_mesh = lod_group_->levels()[level].mesh.get())
+      return level_mesh;
+
+  return mesh_.get();
+}
+
+void MeshRenderer::UpdateMeshBounds() {
+  if (mesh_ && mesh_->bounds_version() != mesh_bounds_version_)
+    UpdateBounds();
+}
+
+void MeshRenderer::UpdateBounds() {
   if (mesh_) {
-    ExceptionState exception_state;
-    auto submeshes = mesh_->GetSubMeshes(exception_state);
+    mesh_bounds_version_ = mesh_->bounds_version();
 
     glm::vec3 min(std::numeric_limits<float>::max());
     glm::vec3 max(std::numeric_limits<float>::lowest());
     bool valid = false;
 
-    for (auto& submesh : submeshes) {
-      if (submesh->boundsMin && submesh->boundsMax) {
-        const glm::vec3& smin = submesh->boundsMin->data();
-        const glm::vec3& smax = submesh->boundsMax->data();
-        min = glm::min(min, smin);
-        max = glm::max(max, smax);
+    for (const auto& bounds : mesh_->GetSubMeshBounds()) {
+      if (bounds.valid) {
+        min = glm::min(min, bounds.min);
+        max = glm::max(max, bounds.max);
         valid = true;
       }
     }
@@ -64,12 +112,14 @@ void MeshRenderer::ComputeAABB(URGE_EXCEPTION) {
     if (valid) {
       bounds_min_ = min;
       bounds_max_ = max;
+      SyncRegistryEntry();
       return;
     }
   }
 
   bounds_min_ = glm::vec3(0.f);
   bounds_max_ = glm::vec3(0.f);
+  SyncRegistryEntry();
 }
 
 scoped_refptr<Vector3> MeshRenderer::GetBoundsMin(URGE_EXCEPTION) {
@@ -80,12 +130,46 @@ scoped_refptr<Vector3> MeshRenderer::GetBoundsMax(URGE_EXCEPTION) {
   return Object::Create<Vector3>(bounds_max_);
 }
 
+scoped_refptr<Node> MeshRenderer::CreateCopy() {
+  // Resources are shared, bounds are local and stay valid
+  auto copy = Object::Create<MeshRenderer>();
+  copy->mesh_ = mesh_;
+  copy->lod_group_ = lod_group_;
+  copy->materials_ = materials_;
+  copy->bounds_min_ = bounds_min_;
+  copy->bounds_max_ = bounds_max_;
+  copy->mesh_bounds_version_ = mesh_bounds_version_;
+  copy->occluder_ = occluder_;
+  return copy;
+}
+
 void MeshRenderer::OnEnterWorld(World* new_world) {
-  new_world->RegisterRenderer(this);
+  registry_handle_ = new_world->RegisterRenderer(this);
 }
 
 void MeshRenderer::OnLeaveWorld(World* old_world) {
-  old_world->UnregisterRenderer(this);
+  old_world->UnregisterRenderer(registry_handle_);
+  registry_handle_ = World::kInvalidRendererHandle;
+}
+
+void MeshRenderer::OnLayerChange() {
+  InvalidateStaticBatch();
+  SyncRegistryEntry();
+}
+
+void MeshRenderer::OnStaticChange() {
+  if (!is_static())
+    InvalidateStaticBatch();
+}
+
+void MeshRenderer::SyncRegistryEntry() {
+  if (registry_handle_ != World::kInvalidRendererHandle)
+    world()->RefreshRenderer(registry_handle_);
+}
+
+void MeshRenderer::InvalidateStaticBatch() {
+  if (static_batch_ != World::kInvalidStaticBatchHandle)
+    world()->ReleaseStaticBatch(static_batch_);
 }
 
 }  // namespace content
@@ -7,12 +7,16 @@
 #include "content/common/vector.h"
 #include "content/resource/material.h"
 #include "content/resource/mesh.h"
+#include "content/scene/lod_group.h"
 #include "content/scene/node.h"
+#include "content/scene/world.h"
 
 namespace content {
 
 URGE_BINDING()
 class MeshRenderer : public Node {
+  BASE_POOL_ALLOCATED(MeshRenderer);
+
  public:
   MeshRenderer();
   ~MeshRenderer() override;
@@ -20,7 +24,11 @@ class MeshRenderer : public Node {
   MeshRenderer(const MeshRenderer&) = delete;
   MeshRenderer& operator=(const MeshRenderer&) = delete;
 
+  MeshRenderer* AsMeshRenderer() override { return this; }
+
   Mesh* mesh() { return mesh_.get(); }
+  LODGroup* lod_group() { return lod_group_.get(); }
+  bool is_occluder() const { return occluder_; }
   const std::vector<scoped_refptr<Material>>& materials() const {
     return materials_;
   }
@@ -28,6 +36,21 @@ class MeshRenderer : public Node {
   const glm::vec3& bounds_min_data() const { return bounds_min_; }
   const glm::vec3& bounds_max_data() const { return bounds_max_; }
 
+  // Mesh drawn at level of detail |level|, levels without a mesh of their
+  // own and levels beyond the group draw the renderer mesh.
+  Mesh* GetLevelMesh(uint32_t level);
+
+  // Recomputes bounds if the cached bounds of the mesh changed since.
+  void UpdateMeshBounds();
+
+  World::RendererHandle registry_handle() const { return registry_handle_; }
+
+  // Static batch drawing this renderer, set by world
+  World::StaticBatchHandle static_batch() const { return static_batch_; }
+  void set_static_batch(World::StaticBatchHandle handle) {
+    static_batch_ = handle;
+  }
+
  public:
   URGE_BINDING()
   static scoped_refptr<MeshRenderer> New(URGE_EXCEPTION);
@@ -35,6 +58,17 @@ class MeshRenderer : public Node {
   URGE_BINDING()
   URGE_ATTRIBUTE_DECLARE(Mesh, scoped_refptr<Mesh>);
 
+  // Renderers with a lod group are not merged into static batches.
+  URGE_BINDING()
+  URGE_ATTRIBUTE_DECLARE(LODGroup, scoped_refptr<LODGroup>);
+
+  // Occluders are rasterized into the occlusion buffer of cameras culling
+  // occlusion, their mesh needs a declared vertex layout.
+  URGE_BINDING()
+  URGE_ATTRIBUTE_DECLARE(Occluder, bool);
+
+  // Bounds follow the mesh automatically, only needed after editing its
+  // submesh objects in place.
   URGE_BINDING()
   void ComputeAABB(URGE_EXCEPTION);
 
@@ -53,15 +87,44 @@ class MeshRenderer : public Node {
                          URGE_EXCEPTION);
 
  protected:
+  scoped_refptr<Node> CreateCopy() override;
+
   void OnEnterWorld(World* new_world) override;
   void OnLeaveWorld(World* old_world) override;
+  void OnLayerChange() override;
+  void OnStaticChange() override;
 
  private:
+  void UpdateBounds();
+  void SyncRegistryEntry();
+  void InvalidateStaticBatch();
+
   scoped_refptr<Mesh> mesh_;
+  scoped_refptr<LODGroup> lod_group_;
   std::vector<scoped_refptr<Material>> materials_;
 
   glm::vec3 bounds_min_;
   glm::vec3 bounds_max_;
+  bool occluder_;
+
+  // Mesh bounds version the bounds were computed from
+  uint32_t mesh_bounds_version_;
+
+  World::RendererHandle registry_handle_;
+  World::StaticBatchHandle static_batch_;
+};
+
+URGE_BINDING()
+class RaycastHit : public Object {
+ public:
+  URGE_BINDING()
+  scoped_refptr<MeshRenderer> renderer = nullptr;
+
+  URGE_BINDING()
+  double distance = 0.0;
+
+  URGE_BINDING()
+  scoped_refptr<Vector3d> point = nullptr;
 };
 
 }  // namespace content
@@ -0,0 +1,344 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/scene/scene_snapshot.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "SDL3/SDL_iostream.h"
+
+#include "components/filesystem/io_service.h"
+#include "content/scene/renderer.h"
+#include "content/scene/world.h"
+
+namespace content {
+
+namespace {
+
+constexpr char kSnapshotMagic[4] = {'U', 'S', 'C', 'N'};
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr uint32_t kSnapshotNone = 0xFFFFFFFFu;
+
+enum SnapshotFlags : uint32_t {
+  kSnapshotRenderer = 1 << 0,
+  kSnapshotStatic = 1 << 1,
+  kSnapshotInactive = 1 << 2,
+};
+
+// File layout:
+//   SnapshotHeader
+//   SnapshotNode[node_count]
+//   uint32_t material_slots[material_slot_count]
+//   char strings[string_bytes]
+struct SnapshotHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t node_count;
+  uint32_t material_slot_count;
+  uint32_t string_bytes;
+  uint32_t reserved;
+};
+
+struct SnapshotNode {
+  double position[3];
+  double rotation[4];  // x, y, z, w
+  double scale[3];
+  int64_t order;
+  uint32_t parent;
+  uint32_t layer;
+  uint32_t flags;
+  uint32_t mesh;
+  uint32_t material_start;
+  uint32_t material_count;
+  uint32_t name_offset;
+  uint32_t name_length;
+};
+
+static_assert(sizeof(SnapshotHeader) == 24);
+static_assert(sizeof(SnapshotNode) == 120);
+
+template <typename Ty>
+std::unordered_map<Ty*, uint32_t> MakeResourceIndex(
+    const earray<scoped_refptr<Ty>>& table) {
+  std::unordered_map<Ty*, uint32_t> index;
+  for (uint32_t i = 0; i < table.size(); ++i)
+    index.emplace(table[i].get(), i);
+  return index;
+}
+
+bool SerializeSnapshot(Node* root,
+                       const earray<scoped_refptr<Mesh>>& meshes,
+                       const earray<scoped_refptr<Material>>& materials,
+                       std::string* output,
+                       ExceptionState& exception_state) {
+  if (!root) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR, "invalid root node.");
+    return false;
+  }
+
+  const auto mesh_index = MakeResourceIndex(meshes);
+  const auto material_index = MakeResourceIndex(materials);
+
+  std::vector<SnapshotNode> records;
+  std::vector<uint32_t> material_slots;
+  std::string strings;
+
+  // Breadth-first, parents are always written before children
+  std::vector<std::pair<Node*, uint32_t>> queue = {{root, kSnapshotNone}};
+  for (size_t i = 0; i < queue.size(); ++i) {
+    Node* node = queue[i].first;
+    Transform* transform = node->transform();
+
+    SnapshotNode record{};
+    const glm::dvec3& position = transform->position();
+    const glm::dquat& rotation = transform->quaternion();
+    const glm::dvec3& scale = transform->scale();
+    for (int c = 0; c < 3; ++c) {
+      record.position[c] = position[c];
+      record.scale[c] = scale[c];
+    }
+    record.rotation[0] = rotation.x;
+    record.rotation[1] = rotation.y;
+    record.rotation[2] = rotation.z;
+    record.rotation[3] = rotation.w;
+    record.order = node->order();
+    record.layer = node->layer();
+    record.flags |= node->is_static() ? kSnapshotStatic : 0;
+    record.flags |= node->is_active() ? 0 : kSnapshotInactive;
+    record.mesh = kSnapshotNone;
+
+    record.name_offset = static_cast<uint32_t>(strings.size());
+    record.name_length = static_cast<uint32_t>(node->name().size());
+    strings += node->name();
+
+    record.parent = queue[i].second;
+
+    if (MeshRenderer* renderer = node->AsMeshRenderer()) {
+      record.flags |= kSnapshotRenderer;
+
+      auto mesh = mesh_index.find(renderer->mesh());
+      if (mesh != mesh_index.end())
+        record.mesh = mesh->second;
+
+      record.material_start = static_cast<uint32_t>(material_slots.size());
+      record.material_count =
+          static_cast<uint32_t>(renderer->materials().size());
+      for (const auto& material : renderer->materials()) {
+        auto it = material_index.find(material.get());
+        material_slots.push_back(it != material_index.end() ? it->second
+                                                            : kSnapshotNone);
+      }
+    }
+
+    records.push_back(record);
+
+    const uint32_t child_count = node->GetChildrenCount(exception_state);
+    for (uint32_t c = 0; c < child_count; ++c)
+      queue.emplace_back(node->GetChildAt(c, exception_state).get(),
+                         static_cast<uint32_t>(i));
+  }
+
+  SnapshotHeader header{};
+  std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+  header.version = kSnapshotVersion;
+  header.node_count = static_cast<uint32_t>(records.size());
+  header.material_slot_count = static_cast<uint32_t>(material_slots.size());
+  header.string_bytes = static_cast<uint32_t>(strings.size());
+
+  output->clear();
+  output->reserve(sizeof(header) + records.size() * sizeof(SnapshotNode) +
+                  material_slots.size() * sizeof(uint32_t) + strings.size());
+  output->append(reinterpret_cast<const char*>(&header), sizeof(header));
+  output->append(reinterpret_cast<const char*>(records.data()),
+                 records.size() * sizeof(SnapshotNode));
+  output->append(reinterpret_cast<const char*>(material_slots.data()),
+                 material_slots.size() * sizeof(uint32_t));
+  output->append(strings);
+
+  return true;
+}
+
+scoped_refptr<Node> LoadSnapshot(
+    const uint8_t* data,
+    uint64_t size,
+    scoped_refptr<Node> parent,
+    const earray<scoped_refptr<Mesh>>& meshes,
+    const earray<scoped_refptr<Material>>& materials,
+    ExceptionState& exception_state) {
+  SnapshotHeader header;
+  if (!data || size < sizeof(header)) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                          "invalid scene snapshot.");
+    return nullptr;
+  }
+
+  std::memcpy(&header, data, sizeof(header));
+  const uint64_t nodes_offset = sizeof(header);
+  const uint64_t slots_offset =
+      nodes_offset + uint64_t(header.node_count) * sizeof(SnapshotNode);
+  const uint64_t strings_offset =
+      slots_offset + uint64_t(header.material_slot_count) * sizeof(uint32_t);
+  if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) ||
+      header.version != kSnapshotVersion || !header.node_count ||
+      strings_offset + header.string_bytes > size) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                          "invalid scene snapshot.");
+    return nullptr;
+  }
+
+  base::ObjectPoolScope pool_scope(
+      parent && parent->world() ? parent->world()->object_pools() : nullptr);
+  const char* strings = reinterpret_cast<const char*>(data + strings_offset);
+  std::vector<scoped_refptr<Node>> nodes(header.node_count);
+  for (uint32_t i = 0; i < header.node_count; ++i) {
+    // Records may be unaligned in caller buffers
+    SnapshotNode record;
+    std::memcpy(&record, data + nodes_offset + i * sizeof(SnapshotNode),
+                sizeof(record));
+
+    const bool valid_parent =
+        i == 0 ? record.parent == kSnapshotNone : record.parent < i;
+    if (!valid_parent ||
+        uint64_t(record.name_offset) + record.name_length >
+            header.string_bytes ||
+        uint64_t(record.material_start) + record.material_count >
+            header.material_slot_count) {
+      exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                            "invalid scene snapshot node: {}", i);
+      return nullptr;
+    }
+
+    scoped_refptr<Node> node;
+    if (record.flags & kSnapshotRenderer) {
+      auto renderer = Object::Create<MeshRenderer>();
+      if (record.mesh < meshes.size())
+        renderer->Put_Mesh(meshes[record.mesh], exception_state);
+
+      for (uint32_t slot = 0; slot < record.material_count; ++slot) {
+        uint32_t material;
+        std::memcpy(&material,
+                    data + slots_offset +
+                        (record.material_start + slot) * sizeof(uint32_t),
+                    sizeof(material));
+        renderer->SetMaterialAtSlot(
+            slot, material < materials.size() ? materials[material] : nullptr,
+            exception_state);
+      }
+
+      node = renderer;
+    } else {
+      node = Object::Create<Node>();
+    }
+
+    // Detached nodes, setters only touch local state
+    node->Put_Name(std::string(strings + record.name_offset,
+                               record.name_length),
+                   exception_state);
+    node->Put_Layer(record.layer, exception_state);
+    node->Put_Order(record.order, exception_state);
+    node->Put_Static(!!(record.flags & kSnapshotStatic), exception_state);
+    node->Put_Active(!(record.flags & kSnapshotInactive), exception_state);
+    node->transform()->SetData(
+        glm::dvec3(record.position[0], record.position[1],
+                   record.position[2]),
+        glm::dquat(record.rotation[3], record.rotation[0], record.rotation[1],
+                   record.rotation[2]),
+        glm::dvec3(record.scale[0], record.scale[1], record.scale[2]));
+
+    if (i > 0)
+      node->ResetParent(nodes[record.parent].get());
+    nodes[i] = std::move(node);
+  }
+
+  // One world setup walk over the complete subtree
+  if (parent)
+    nodes.front()->Put_Parent(parent, exception_state);
+
+  return nodes.front();
+}
+
+}  // namespace
+
+// static
+estring SceneSnapshot::Serialize(scoped_refptr<Node> root,
+                                 earray<scoped_refptr<Mesh>> meshes,
+                                 earray<scoped_refptr<Material>> materials,
+                                 URGE_EXCEPTION) {
+  std::string output;
+  SerializeSnapshot(root.get(), meshes, materials, &output, exception_state);
+  return output;
+}
+
+// static
+void SceneSnapshot::SaveFile(scoped_refptr<Node> root,
+                             estring filename,
+                             earray<scoped_refptr<Mesh>> meshes,
+                             earray<scoped_refptr<Material>> materials,
+                             URGE_EXCEPTION) {
+  std::string output;
+  if (!SerializeSnapshot(root.get(), meshes, materials, &output,
+                         exception_state))
+    return;
+
+  filesystem::IOState io_state;
+  SDL_IOStream* stream =
+      filesystem::IOService::Instance()->OpenWrite(filename, &io_state);
+  if (!stream) {
+    exception_state.Throw(ExceptionCode::IO_ERROR, "{}",
+                          io_state.error_message);
+    return;
+  }
+
+  const size_t written = SDL_WriteIO(stream, output.data(), output.size());
+  SDL_CloseIO(stream);
+  if (written != output.size())
+    exception_state.Throw(ExceptionCode::IO_ERROR,
+                          "failed to write scene snapshot: {}", filename);
+}
+
+// static
+scoped_refptr<Node> SceneSnapshot::LoadMemory(
+    epointer data,
+    uint64_t size,
+    scoped_refptr<Node> parent,
+    earray<scoped_refptr<Mesh>> meshes,
+    earray<scoped_refptr<Material>> materials,
+    URGE_EXCEPTION) {
+  return LoadSnapshot(static_cast<const uint8_t*>(data), size, parent, meshes,
+                      materials, exception_state);
+}
+
+// static
+scoped_refptr<Node> SceneSnapshot::LoadFile(
+    estring filename,
+    scoped_refptr<Node> parent,
+    earray<scoped_refptr<Mesh>> meshes,
+    earray<scoped_refptr<Material>> materials,
+    URGE_EXCEPTION) {
+  filesystem::IOState io_state;
+  SDL_IOStream* stream =
+      filesystem::IOService::Instance()->OpenReadRaw(filename, &io_state);
+  if (!stream) {
+    exception_state.Throw(ExceptionCode::IO_ERROR, "{}",
+                          io_state.error_message);
+    return nullptr;
+  }
+
+  // Packaged files can not be mapped, read in one block and parse in place
+  size_t size = 0;
+  void* data = SDL_LoadFile_IO(stream, &size, true);
+  if (!data) {
+    exception_state.Throw(ExceptionCode::IO_ERROR,
+                          "failed to read scene snapshot: {}", filename);
+    return nullptr;
+  }
+
+  auto root = LoadSnapshot(static_cast<const uint8_t*>(data), size, parent,
+                           meshes, materials, exception_state);
+  SDL_free(data);
+  return root;
+}
+
+}  // namespace content
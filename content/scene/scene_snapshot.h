@@ -0,0 +1,56 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include "content/content_config.h"
+#include "content/resource/material.h"
+#include "content/resource/mesh.h"
+#include "content/scene/node.h"
+
+namespace content {
+
+// Binary snapshot of a node subtree. Records are fixed-size and addressed by
+// offsets only, so a snapshot is parsed in place from one contiguous buffer,
+// either a mapped file or a single read of a packaged file. Nodes are stored
+// parents first, meshes and materials as indices into tables supplied by the
+// caller on both save and load. Nodes other than MeshRenderer are restored as
+// plain nodes.
+URGE_BINDING()
+class SceneSnapshot : public Object {
+ public:
+  URGE_BINDING()
+  static estring Serialize(scoped_refptr<Node> root,
+                           earray<scoped_refptr<Mesh>> meshes,
+                           earray<scoped_refptr<Material>> materials,
+                           URGE_EXCEPTION);
+
+  URGE_BINDING()
+  static void SaveFile(scoped_refptr<Node> root,
+                       estring filename,
+                       earray<scoped_refptr<Mesh>> meshes,
+                       earray<scoped_refptr<Material>> materials,
+                       URGE_EXCEPTION);
+
+  // Builds the subtree detached and attaches it under |parent| (optional)
+  // in a single world setup pass.
+  URGE_BINDING()
+  static scoped_refptr<Node> LoadMemory(
+      epointer data,
+      uint64_t size,
+      scoped_refptr<Node> parent,
+      earray<scoped_refptr<Mesh>> meshes,
+      earray<scoped_refptr<Material>> materials,
+      URGE_EXCEPTION);
+
+  URGE_BINDING()
+  static scoped_refptr<Node> LoadFile(
+      estring filename,
+      scoped_refptr<Node> parent,
+      earray<scoped_refptr<Mesh>> meshes,
+      earray<scoped_refptr<Material>> materials,
+      URGE_EXCEPTION);
+};
+
+}  // namespace content
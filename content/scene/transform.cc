@@ -77,37 +77,46 @@ Quaternion& Quaternion::Set(scoped_refptr<Quaternion> value, URGE_EXCEPTION) {
 ///
 
 Transform::Transform()
-    : position_(Object::Create<Vector3d>()),
-      quaternion_(Object::Create<Quaternion>()),
-      scale_(Object::Create<Vector3d>(glm::dvec3(1.0))) {
-  auto value_change_handler =
-      base::BindRepeating(&Transform::on_change, base::Unretained(this));
-
-  position_->set_change_handler(value_change_handler);
-  quaternion_->set_change_handler(value_change_handler);
-  scale_->set_change_handler(value_change_handler);
+    : position_(0.0),
+      quaternion_(1.0, 0.0, 0.0, 0.0),
+      scale_(1.0),
+      object_pools_(base::ObjectPoolScope::Current()),
+      syncing_proxies_(false) {}
+
+Transform::~Transform() {
+  // Proxies may outlive transform in script
+  if (position_proxy_)
+    position_proxy_->set_change_handler(base::RepeatingClosure());
+  if (quaternion_proxy_)
+    quaternion_proxy_->set_change_handler(base::RepeatingClosure());
+  if (scale_proxy_)
+    scale_proxy_->set_change_handler(base::RepeatingClosure());
 }
 
-glm::dmat4x4 Transform::GetModelMatrix(const glm::dvec3& position_offset) {
-  const auto& position = position_->data();
-  const auto& quaternion = quaternion_->data();
-  const auto& scale = scale_->data();
+void Transform::SetData(const glm::dvec3& position,
+                        const glm::dquat& quaternion,
+                        const glm::dvec3& scale) {
+  position_ = position;
+  quaternion_ = quaternion;
+  scale_ = scale;
 
+  SyncProxies();
+  on_change();
+}
+
+glm::dmat4x4 Transform::GetModelMatrix() {
   glm::dmat4 model(1.0);
-  model = glm::translate(model, position);
-  model = model * glm::mat4_cast(quaternion);
-  model = glm::scale(model, scale);
+  model = glm::translate(model, position_);
+  model = model * glm::mat4_cast(quaternion_);
+  model = glm::scale(model, scale_);
 
   return model;
 }
 
 glm::dmat4x4 Transform::GetForwardMatrix() {
-  const auto& quaternion = quaternion_->data();
-  const auto& scale = scale_->data();
-
   glm::dmat4 model(1.0);
-  model = model * glm::mat4_cast(quaternion);
-  model = glm::scale(model, scale);
+  model = model * glm::mat4_cast(quaternion_);
+  model = glm::scale(model, scale_);
 
   return model;
 }
@@ -116,28 +125,80 @@ URGE_ATTRIBUTE_DEFINE(
     Transform,
     Position,
     scoped_refptr<Vector3d>,
-    { return position_; },
-    { position_->Set(value, exception_state); });
+    {
+      if (!position_proxy_) {
+        base::ObjectPoolScope pool_scope(object_pools_.get());
+        position_proxy_ = Object::Create<Vector3d>(position_);
+        position_proxy_->set_change_handler(base::BindRepeating(
+            &Transform::ProxyChange, base::Unretained(this)));
+      }
+
+      return position_proxy_;
+    },
+    { SetData(value->data(), quaternion_, scale_); });
 
 URGE_ATTRIBUTE_DEFINE(
     Transform,
     Quaternion,
     scoped_refptr<Quaternion>,
-    { return quaternion_; },
-    { quaternion_->Set(value, exception_state); });
+    {
+      if (!quaternion_proxy_) {
+        base::ObjectPoolScope pool_scope(object_pools_.get());
+        quaternion_proxy_ = Object::Create<Quaternion>();
+        quaternion_proxy_->set_data(quaternion_);
+        quaternion_proxy_->set_change_handler(base::BindRepeating(
+            &Transform::ProxyChange, base::Unretained(this)));
+      }
+
+      return quaternion_proxy_;
+    },
+    { SetData(position_, value->data(), scale_); });
 
 URGE_ATTRIBUTE_DEFINE(
     Transform,
     Scale,
     scoped_refptr<Vector3d>,
-    { return scale_; },
-    { scale_->Set(value, exception_state); });
+    {
+      if (!scale_proxy_) {
+        base::ObjectPoolScope pool_scope(object_pools_.get());
+        scale_proxy_ = Object::Create<Vector3d>(scale_);
+        scale_proxy_->set_change_handler(base::BindRepeating(
+            &Transform::ProxyChange, base::Unretained(this)));
+      }
+
+      return scale_proxy_;
+    },
+    { SetData(position_, quaternion_, value->data()); });
 
 Transform& Transform::Set(scoped_refptr<Transform> value, URGE_EXCEPTION) {
-  position_->Set(value->position_, exception_state);
-  quaternion_->Set(value->quaternion_, exception_state);
-  scale_->Set(value->scale_, exception_state);
+  SetData(value->position_, value->quaternion_, value->scale_);
   return *this;
 }
 
+void Transform::ProxyChange() {
+  if (syncing_proxies_)
+    return;
+
+  // Proxies mirror inline values, pull all of them back.
+  if (position_proxy_)
+    position_ = position_proxy_->data();
+  if (quaternion_proxy_)
+    quaternion_ = quaternion_proxy_->data();
+  if (scale_proxy_)
+    scale_ = scale_proxy_->data();
+
+  on_change();
+}
+
+void Transform::SyncProxies() {
+  syncing_proxies_ = true;
+  if (position_proxy_)
+    position_proxy_->set_data(position_);
+  if (quaternion_proxy_)
+    quaternion_proxy_->set_data(quaternion_);
+  if (scale_proxy_)
+    scale_proxy_->set_data(scale_);
+  syncing_proxies_ = false;
+}
+
 }  // namespace content
@@ -7,6 +7,7 @@
 #include "glm/gtc/quaternion.hpp"
 #include "glm/mat4x4.hpp"
 
+#include "base/memory/object_pool.h"
 #include "content/common/object.h"
 #include "content/common/vector.h"
 
@@ -14,6 +15,8 @@ namespace content {
 
 URGE_BINDING()
 class Quaternion : public Constant {
+  BASE_POOL_ALLOCATED(Quaternion);
+
  public:
   Quaternion();
 
@@ -49,19 +52,29 @@ class Quaternion : public Constant {
   glm::dquat value_;
 };
 
+// TRS is stored inline, script-facing component objects are only created on
+// first access and kept in sync with the inline values afterwards.
 URGE_BINDING()
 class Transform : public Constant {
+  BASE_POOL_ALLOCATED(Transform);
+
  public:
   Transform();
+  ~Transform() override;
 
   Transform(const Transform&) = delete;
   Transform& operator=(const Transform&) = delete;
 
-  glm::dvec3 position() { return position_->data(); }
-  glm::dquat quaternion() { return quaternion_->data(); }
-  glm::dvec3 scale() { return scale_->data(); }
+  const glm::dvec3& position() const { return position_; }
+  const glm::dquat& quaternion() const { return quaternion_; }
+  const glm::dvec3& scale() const { return scale_; }
+
+  // Assigns all components with a single change notification.
+  void SetData(const glm::dvec3& position,
+               const glm::dquat& quaternion,
+               const glm::dvec3& scale);
 
-  glm::dmat4x4 GetModelMatrix(const glm::dvec3& position_offset);
+  glm::dmat4x4 GetModelMatrix();
   glm::dmat4x4 GetForwardMatrix();
 
  public:
@@ -78,9 +91,20 @@ class Transform : public Constant {
   Transform& Set(scoped_refptr<Transform> value, URGE_EXCEPTION);
 
  private:
-  scoped_refptr<Vector3d> position_;
-  scoped_refptr<Quaternion> quaternion_;
-  scoped_refptr<Vector3d> scale_;
+  void ProxyChange();
+  void SyncProxies();
+
+  glm::dvec3 position_;
+  glm::dquat quaternion_;
+  glm::dvec3 scale_;
+
+  // Lazily created script proxies, allocated from the pools this transform
+  // was created with
+  scoped_refptr<base::ObjectPoolSet> object_pools_;
+  scoped_refptr<Vector3d> position_proxy_;
+  scoped_refptr<Quaternion> quaternion_proxy_;
+  scoped_refptr<Vector3d> scale_proxy_;
+  bool syncing_proxies_;
 };
 
 }  // namespace content
@@ -0,0 +1,342 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/scene/transform_hierarchy.h"
+
+#include <algorithm>
+
+#include "base/template/vector_util.h"
+#include "base/thread/worker_pool.h"
+
+namespace content {
+
+namespace {
+
+// Levels narrower than this are not worth the dispatch cost
+constexpr size_t kParallelLevelThreshold = 2048;
+constexpr size_t kParallelGrain = 512;
+
+// Fall back to a full update once this fraction of entries changed
+constexpr size_t kFullUpdateRatio = 4;
+
+}  // namespace
+
+TransformHierarchy::TransformHierarchy()
+    : child_offsets_(1, 0),
+      changed_count_(0),
+      all_changed_(false),
+      serial_(0),
+      structure_dirty_(false) {}
+
+TransformHierarchy::~TransformHierarchy() = default;
+
+void TransformHierarchy::Reserve(size_t count) {
+  if (count > free_handles_.size()) {
+    const size_t sparse = count - free_handles_.size();
+    base::ReserveAdditional(handle_to_index_, sparse);
+    base::ReserveAdditional(parent_handles_, sparse);
+    base::ReserveAdditional(generations_, sparse);
+    base::ReserveAdditional(dirty_flags_, sparse);
+  }
+
+  base::ReserveAdditional(handles_, count);
+  base::ReserveAdditional(parents_, count);
+  base::ReserveAdditional(positions_, count);
+  base::ReserveAdditional(rotations_, count);
+  base::ReserveAdditional(scales_, count);
+  base::ReserveAdditional(world_matrices_, count);
+  base::ReserveAdditional(update_stamps_, count);
+  base::ReserveAdditional(freeze_states_, count);
+  base::ReserveAdditional(child_offsets_, count);
+}
+
+TransformHierarchy::Handle TransformHierarchy::Allocate() {
+  Handle handle;
+  if (!free_handles_.empty()) {
+    handle = free_handles_.back();
+    free_handles_.pop_back();
+  } else {
+    handle = static_cast<Handle>(handle_to_index_.size());
+    handle_to_index_.push_back(kNoParent);
+    parent_handles_.push_back(kInvalidHandle);
+    generations_.push_back(0);
+    dirty_flags_.push_back(0);
+  }
+
+  handle_to_index_[handle] = static_cast<uint32_t>(handles_.size());
+  parent_handles_[handle] = kInvalidHandle;
+
+  handles_.push_back(handle);
+  parents_.push_back(kNoParent);
+  positions_.emplace_back(0.0);
+  rotations_.emplace_back(1.0, 0.0, 0.0, 0.0);
+  scales_.emplace_back(1.0);
+  world_matrices_.emplace_back(1.0);
+  update_stamps_.push_back(0);
+  freeze_states_.push_back(kDynamic);
+
+  // Placed behind the deepest level until next sort
+  structure_dirty_ = true;
+
+  return handle;
+}
+
+void TransformHierarchy::Release(Handle handle) {
+  const uint32_t index = handle_to_index_[handle];
+  const uint32_t last = static_cast<uint32_t>(handles_.size() - 1);
+
+  // Swap-remove the dense entry, order will be restored on next update.
+  if (index != last) {
+    handles_[index] = handles_[last];
+    parents_[index] = parents_[last];
+    positions_[index] = positions_[last];
+    rotations_[index] = rotations_[last];
+    scales_[index] = scales_[last];
+    world_matrices_[index] = world_matrices_[last];
+    update_stamps_[index] = update_stamps_[last];
+    freeze_states_[index] = freeze_states_[last];
+    handle_to_index_[handles_[index]] = index;
+  }
+
+  handles_.pop_back();
+  parents_.pop_back();
+  positions_.pop_back();
+  rotations_.pop_back();
+  scales_.pop_back();
+  world_matrices_.pop_back();
+  update_stamps_.pop_back();
+  freeze_states_.pop_back();
+
+  handle_to_index_[handle] = kNoParent;
+  parent_handles_[handle] = kInvalidHandle;
+  free_handles_.push_back(handle);
+
+  structure_dirty_ = true;
+}
+
+void TransformHierarchy::SetParent(Handle handle, Handle parent) {
+  if (parent_handles_[handle] == parent)
+    return;
+
+  parent_handles_[handle] = parent;
+  structure_dirty_ = true;
+}
+
+void TransformHierarchy::SetLocal(Handle handle,
+                                  const glm::dvec3& position,
+                                  const glm::dquat& rotation,
+                                  const glm::dvec3& scale) {
+  const uint32_t index = handle_to_index_[handle];
+  positions_[index] = position;
+  rotations_[index] = rotation;
+  scales_[index] = scale;
+  MarkDirty(handle);
+}
+
+void TransformHierarchy::SetFrozen(Handle handle, bool frozen) {
+  uint8_t& state = freeze_states_[handle_to_index_[handle]];
+  if ((state != kDynamic) == frozen)
+    return;
+
+  // Pending entries freeze right after their next computation
+  state = frozen ? kFreezePending : kDynamic;
+  MarkDirty(handle);
+}
+
+const glm::dmat4x4& TransformHierarchy::GetWorldMatrix(Handle handle) {
+  Update();
+  return world_matrices_[handle_to_index_[handle]];
+}
+
+void TransformHierarchy::Update(base::WorkerPool* pool) {
+  if (!structure_dirty_ && dirty_handles_.empty())
+    return;
+
+  ++serial_;
+  if (structure_dirty_) {
+    SortHierarchy();
+    structure_dirty_ = false;
+    UpdateAll(pool);
+  } else if (dirty_handles_.size() * kFullUpdateRatio >= handles_.size()) {
+    UpdateAll(pool);
+  } else {
+    UpdateDirty();
+  }
+
+  for (auto handle : dirty_handles_)
+    dirty_flags_[handle] = 0;
+  dirty_handles_.clear();
+}
+
+void TransformHierarchy::ClearChanges() {
+  changed_ranges_.clear();
+  changed_count_ = 0;
+  all_changed_ = false;
+}
+
+void TransformHierarchy::MarkDirty(Handle handle) {
+  if (!dirty_flags_[handle]) {
+    dirty_flags_[handle] = 1;
+    dirty_handles_.push_back(handle);
+  }
+}
+
+void TransformHierarchy::SortHierarchy() {
+  const size_t count = handles_.size();
+
+  // Parent index and children of each entry in current order
+  std::vector<uint32_t> parents(count);
+  std::vector<uint32_t> child_starts(count + 1, 0);
+  for (size_t i = 0; i < count; ++i) {
+    const Handle parent = parent_handles_[handles_[i]];
+    parents[i] =
+        parent != kInvalidHandle ? handle_to_index_[parent] : kNoParent;
+    if (parents[i] != kNoParent)
+      ++child_starts[parents[i] + 1];
+  }
+
+  for (size_t i = 1; i <= count; ++i)
+    child_starts[i] += child_starts[i - 1];
+
+  std::vector<uint32_t> children(count);
+  std::vector<uint32_t> cursors(child_starts.begin(), child_starts.end() - 1);
+  for (size_t i = 0; i < count; ++i)
+    if (parents[i] != kNoParent)
+      children[cursors[parents[i]]++] = static_cast<uint32_t>(i);
+
+  // Breadth-first order, roots keep their relative order
+  std::vector<uint32_t> order;
+  order.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    if (parents[i] == kNoParent)
+      order.push_back(static_cast<uint32_t>(i));
+
+  level_offsets_.assign(1, 0);
+  child_offsets_.resize(count + 1);
+  size_t level_end = order.size();
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (i == level_end) {
+      level_offsets_.push_back(static_cast<uint32_t>(i));
+      level_end = order.size();
+    }
+
+    const uint32_t source = order[i];
+    child_offsets_[i] = static_cast<uint32_t>(order.size());
+    order.insert(order.end(), children.begin() + child_starts[source],
+                 children.begin() + child_starts[source + 1]);
+  }
+  level_offsets_.push_back(static_cast<uint32_t>(order.size()));
+  child_offsets_[count] = static_cast<uint32_t>(count);
+
+  // Permute dense storage, frozen entries keep their world matrix
+  std::vector<Handle> handles(count);
+  std::vector<glm::dvec3> positions(count);
+  std::vector<glm::dquat> rotations(count);
+  std::vector<glm::dvec3> scales(count);
+  std::vector<glm::dmat4x4> world_matrices(count);
+  std::vector<uint32_t> update_stamps(count);
+  std::vector<uint8_t> freeze_states(count);
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t source = order[i];
+    handles[i] = handles_[source];
+    positions[i] = positions_[source];
+    rotations[i] = rotations_[source];
+    scales[i] = scales_[source];
+    world_matrices[i] = world_matrices_[source];
+    update_stamps[i] = update_stamps_[source];
+    freeze_states[i] = freeze_states_[source];
+    handle_to_index_[handles[i]] = static_cast<uint32_t>(i);
+  }
+
+  handles_.swap(handles);
+  positions_.swap(positions);
+  rotations_.swap(rotations);
+  scales_.swap(scales);
+  world_matrices_.swap(world_matrices);
+  update_stamps_.swap(update_stamps);
+  freeze_states_.swap(freeze_states);
+
+  for (size_t i = 0; i < count; ++i) {
+    const Handle parent = parent_handles_[handles_[i]];
+    parents_[i] =
+        parents[order[i]] != kNoParent ? handle_to_index_[parent] : kNoParent;
+  }
+}
+
+void TransformHierarchy::UpdateAll(base::WorkerPool* pool) {
+  changed_ranges_.clear();
+  all_changed_ = true;
+
+  // Levels run in order, entries inside a level only read previous levels.
+  for (size_t level = 0; level + 1 < level_offsets_.size(); ++level) {
+    const size_t begin = level_offsets_[level];
+    const size_t end = level_offsets_[level + 1];
+
+    if (pool && end - begin >= kParallelLevelThreshold) {
+      pool->ParallelFor(end - begin, kParallelGrain,
+                        [this, begin](size_t first, size_t last) {
+                          UpdateRange(begin + first, begin + last);
+                        });
+    } else {
+      UpdateRange(begin, end);
+    }
+  }
+}
+
+void TransformHierarchy::UpdateDirty() {
+  dirty_indices_.clear();
+  for (auto handle : dirty_handles_)
+    if (handle_to_index_[handle] != kNoParent)
+      dirty_indices_.push_back(handle_to_index_[handle]);
+
+  // Ancestors come first, subtrees already refreshed are skipped.
+  std::sort(dirty_indices_.begin(), dirty_indices_.end());
+  for (auto index : dirty_indices_) {
+    if (update_stamps_[index] == serial_)
+      continue;
+
+    // Descendants are contiguous on every level below
+    size_t begin = index, end = index + 1;
+    while (begin < end) {
+      UpdateRange(begin, end);
+      if (!all_changed_) {
+        changed_ranges_.emplace_back(static_cast<uint32_t>(begin),
+                                     static_cast<uint32_t>(end));
+        changed_count_ += end - begin;
+      }
+      begin = child_offsets_[begin];
+      end = child_offsets_[end];
+    }
+  }
+
+  // Reported changes collapse to all once they cover the world
+  if (changed_count_ >= handles_.size()) {
+    changed_ranges_.clear();
+    all_changed_ = true;
+  }
+}
+
+void TransformHierarchy::UpdateRange(size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    if (freeze_states_[i] == kFrozen)
+      continue;
+
+    glm::dmat4x4 local = glm::mat4_cast(rotations_[i]);
+    local[0] *= scales_[i].x;
+    local[1] *= scales_[i].y;
+    local[2] *= scales_[i].z;
+    local[3] = glm::dvec4(positions_[i], 1.0);
+
+    const uint32_t parent = parents_[i];
+    world_matrices_[i] =
+        parent == kNoParent ? local : world_matrices_[parent] * local;
+
+    update_stamps_[i] = serial_;
+    generations_[handles_[i]] = serial_;
+    if (freeze_states_[i] == kFreezePending)
+      freeze_states_[i] = kFrozen;
+  }
+}
+
+}  // namespace content
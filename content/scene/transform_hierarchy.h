@@ -0,0 +1,136 @@
+// Copyright 2018-2026 Admenri.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "glm/gtc/quaternion.hpp"
+#include "glm/mat4x4.hpp"
+
+namespace base {
+class WorkerPool;
+}  // namespace base
+
+namespace content {
+
+// Flat structure-of-arrays storage of all transforms in a world. Entries are
+// kept in breadth-first order: parents always precede their children, entries
+// of the same depth form a level without inner dependencies, and descendants
+// of any entry occupy one contiguous range per level.
+// Changes are collected into a dirty list, an update only recomputes the
+// subtrees below changed entries unless most of the world has changed, in
+// which case levels are processed linearly (in parallel for wide levels).
+// Nodes refer to their entry through a stable handle, the dense index of an
+// entry may change whenever the hierarchy structure changes.
+class TransformHierarchy {
+ public:
+  using Handle = uint32_t;
+  static constexpr Handle kInvalidHandle = std::numeric_limits<Handle>::max();
+
+  TransformHierarchy();
+  ~TransformHierarchy();
+
+  TransformHierarchy(const TransformHierarchy&) = delete;
+  TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+  Handle Allocate();
+  void Release(Handle handle);
+
+  // Preallocates storage of |count| further allocations.
+  void Reserve(size_t count);
+
+  void SetParent(Handle handle, Handle parent);
+  void SetLocal(Handle handle,
+                const glm::dvec3& position,
+                const glm::dquat& rotation,
+                const glm::dvec3& scale);
+
+  // A frozen entry keeps its world matrix once computed and is skipped by
+  // later updates, its descendants still follow the frozen matrix.
+  void SetFrozen(Handle handle, bool frozen);
+
+  // Resolves pending changes before returning the absolute world matrix.
+  const glm::dmat4x4& GetWorldMatrix(Handle handle);
+
+  // World matrix as of the last update, for callers which updated already.
+  const glm::dmat4x4& world_matrix(Handle handle) const {
+    return world_matrices_[handle_to_index_[handle]];
+  }
+
+  // Serial of the last update which recomputed the world matrix of |handle|.
+  uint32_t GetGeneration(Handle handle) const { return generations_[handle]; }
+
+  // Recomputes world matrices of changed entries and their descendants, a
+  // full update splits wide levels across |pool| workers when provided.
+  void Update(base::WorkerPool* pool = nullptr);
+
+  size_t size() const { return handles_.size(); }
+  uint32_t serial() const { return serial_; }
+
+  // Entries recomputed by updates since the last ClearChanges(), as dense
+  // index ranges. Full updates, which also follow every structure change,
+  // report all entries changed instead.
+  using IndexRange = std::pair<uint32_t, uint32_t>;
+  bool all_changed() const { return all_changed_; }
+  const std::vector<IndexRange>& changed_ranges() const {
+    return changed_ranges_;
+  }
+  Handle handle_at(uint32_t index) const { return handles_[index]; }
+  void ClearChanges();
+
+ private:
+  static constexpr uint32_t kNoParent = std::numeric_limits<uint32_t>::max();
+
+  enum FreezeState : uint8_t {
+    kDynamic = 0,
+    kFreezePending,
+    kFrozen,
+  };
+
+  void MarkDirty(Handle handle);
+  void SortHierarchy();
+  void UpdateAll(base::WorkerPool* pool);
+  void UpdateDirty();
+  void UpdateRange(size_t begin, size_t end);
+
+  // Sparse data, indexed by handle
+  std::vector<uint32_t> handle_to_index_;
+  std::vector<Handle> parent_handles_;
+  std::vector<uint32_t> generations_;
+  std::vector<uint8_t> dirty_flags_;
+  std::vector<Handle> free_handles_;
+
+  // Dense data, indexed by breadth-first entry index
+  std::vector<Handle> handles_;
+  std::vector<uint32_t> parents_;
+  std::vector<glm::dvec3> positions_;
+  std::vector<glm::dquat> rotations_;
+  std::vector<glm::dvec3> scales_;
+  std::vector<glm::dmat4x4> world_matrices_;
+  std::vector<uint32_t> update_stamps_;
+  std::vector<uint8_t> freeze_states_;
+
+  // Dense index of the first child of each entry, |size + 1| entries
+  std::vector<uint32_t> child_offsets_;
+
+  // Dense index range of each depth level, |levels + 1| entries
+  std::vector<uint32_t> level_offsets_;
+
+  // Entries changed since last update
+  std::vector<Handle> dirty_handles_;
+  std::vector<uint32_t> dirty_indices_;
+
+  // Entries recomputed since last ClearChanges()
+  std::vector<IndexRange> changed_ranges_;
+  size_t changed_count_;
+  bool all_changed_;
+
+  uint32_t serial_;
+  bool structure_dirty_;
+};
+
+}  // namespace content
@@ -5,18 +5,107 @@
 #include "content/scene/world.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <tuple>
 
+#include "glm/gtc/matrix_inverse.hpp"
+
+#include "base/thread/worker_pool.h"
 #include "content/scene/camera.h"
 #include "content/scene/renderer.h"
 
 namespace content {
 
+namespace {
+
+// Doubles per node in packed transform buffers
+constexpr size_t kPackedTransformSize = 10;
+
+// Doubles per ray in packed ray buffers
+constexpr size_t kPackedRaySize = 6;
+
+// Generation never produced by the hierarchy, forces a refit
+constexpr uint32_t kStaleGeneration = std::numeric_limits<uint32_t>::max();
+
+AABB ComputeWorldBounds(const RendererEntry& entry,
+                        const glm::dmat4x4& world_matrix) {
+  // Center-extent transform in double, single precision result
+  const glm::dvec3 center =
+      (glm::dvec3(entry.bounds_min) + glm::dvec3(entry.bounds_max)) * 0.5;
+  const glm::dvec3 extent =
+      (glm::dvec3(entry.bounds_max) - glm::dvec3(entry.bounds_min)) * 0.5;
+
+  const glm::dvec3 world_center =
+      glm::dvec3(world_matrix * glm::dvec4(center, 1.0));
+  const glm::dvec3 world_extent =
+      glm::abs(glm::dvec3(world_matrix[0])) * extent.x +
+      glm::abs(glm::dvec3(world_matrix[1])) * extent.y +
+      glm::abs(glm::dvec3(world_matrix[2])) * extent.z;
+
+  return AABB(glm::vec3(world_center - world_extent),
+              glm::vec3(world_center + world_extent));
+}
+
+// Clips [t_min, t_max] of the ray to the box, false if the ray misses.
+bool ClipRayToBox(const glm::dvec3& origin,
+                  const glm::dvec3& direction,
+                  const glm::dvec3& box_min,
+                  const glm::dvec3& box_max,
+                  double& t_min,
+                  double& t_max) {
+  for (int axis = 0; axis < 3; ++axis) {
+    if (std::abs(direction[axis]) < 1e-12) {
+      // Parallel to slab
+      if (origin[axis] < box_min[axis] || origin[axis] > box_max[axis])
+        return false;
+      continue;
+    }
+
+    const double inv_direction = 1.0 / direction[axis];
+    double t0 = (box_min[axis] - origin[axis]) * inv_direction;
+    double t1 = (box_max[axis] - origin[axis]) * inv_direction;
+    if (t0 > t1)
+      std::swap(t0, t1);
+
+    t_min = std::max(t_min, t0);
+    t_max = std::min(t_max, t1);
+    if (t_min > t_max)
+      return false;
+  }
+
+  return true;
+}
+
+}  // namespace
+
 // static
 scoped_refptr<World> World::New(URGE_EXCEPTION) {
   return Object::Create<World>();
 }
 
-World::World() {}
+World::World()
+    : object_pools_(base::MakeRefCounted<base::ObjectPoolSet>()),
+      registry_serial_(0) {
+  base::ObjectPoolScope pool_scope(object_pools_.get());
+  static_batch_root_ = Object::Create<Node>();
+  static_batch_root_->root() = true;
+  static_batch_root_->SetupWorld(this, nullptr);
+}
+
+World::~World() {
+  // Release hierarchy handles held by nodes before storage destruction
+  ExceptionState exception_state;
+  ClearStaticBatches(exception_state);
+  static_batch_root_->SetupWorld(nullptr, this);
+
+  if (root_) {
+    root_->root() = false;
+    root_->SetupWorld(nullptr, this);
+  }
+}
 
 URGE_ATTRIBUTE_DEFINE(
     World,
@@ -48,24 +137,640 @@ URGE_ATTRIBUTE_DEFINE(
       root_ = value;
     });
 
-void World::RegisterCamera(Camera* camera) {
-  cameras_.push_back(camera);
+scoped_refptr<Node> World::FindByName(estring name, URGE_EXCEPTION) {
+  auto it = name_index_.find(name);
+  return it != name_index_.end() ? it->second.front() : nullptr;
+}
+
+scoped_refptr<Node> World::CreateNode(URGE_EXCEPTION) {
+  base::ObjectPoolScope pool_scope(object_pools_.get());
+  return Object::Create<Node>();
+}
+
+scoped_refptr<MeshRenderer> World::CreateMeshRenderer(URGE_EXCEPTION) {
+  base::ObjectPoolScope pool_scope(object_pools_.get());
+  return Object::Create<MeshRenderer>();
+}
+
+scoped_refptr<Vector3d> World::CreateVector3d(double x,
+                                              double y,
+                                              double z,
+                                              URGE_EXCEPTION) {
+  base::ObjectPoolScope pool_scope(object_pools_.get());
+  return Object::Create<Vector3d>(x, y, z);
+}
+
+void World::WriteTransforms(earray<scoped_refptr<Node>> nodes,
+                            epointer data,
+                            uint32_t count,
+                            URGE_EXCEPTION) {
+  if (!CheckTransformAccess(nodes, data, count, exception_state))
+    return;
+
+  const double* packed = static_cast<const double*>(data);
+  for (auto& node : nodes) {
+    const glm::dvec3 position(packed[0], packed[1], packed[2]);
+    const glm::dquat quaternion(packed[6], packed[3], packed[4], packed[5]);
+    const glm::dvec3 scale(packed[7], packed[8], packed[9]);
+    node->transform()->SetData(position, quaternion, scale);
+
+    packed += kPackedTransformSize;
+  }
+}
+
+void World::ReadTransforms(earray<scoped_refptr<Node>> nodes,
+                           epointer data,
+                           uint32_t count,
+                           URGE_EXCEPTION) {
+  if (!CheckTransformAccess(nodes, data, count, exception_state))
+    return;
+
+  double* packed = static_cast<double*>(data);
+  for (auto& node : nodes) {
+    auto* transform = node->transform();
+    const glm::dvec3 position = transform->position();
+    const glm::dquat quaternion = transform->quaternion();
+    const glm::dvec3 scale = transform->scale();
+
+    packed[0] = position.x;
+    packed[1] = position.y;
+    packed[2] = position.z;
+    packed[3] = quaternion.x;
+    packed[4] = quaternion.y;
+    packed[5] = quaternion.z;
+    packed[6] = quaternion.w;
+    packed[7] = scale.x;
+    packed[8] = scale.y;
+    packed[9] = scale.z;
+
+    packed += kPackedTransformSize;
+  }
+}
+
+scoped_refptr<RaycastHit> World::Raycast(scoped_refptr<Vector3d> origin,
+                                         scoped_refptr<Vector3d> direction,
+                                         double max_distance,
+                                         uint64_t layer_mask,
+                                         URGE_EXCEPTION) {
+  if (!origin || !direction) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR, "invalid ray.");
+    return nullptr;
+  }
+
+  if (glm::length(direction->data()) <= 0.0) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                          "invalid ray direction.");
+    return nullptr;
+  }
+
+  UpdateSpatialIndex();
+  return RaycastClosest(origin->data(), glm::normalize(direction->data()),
+                        max_distance, layer_mask);
+}
+
+earray<scoped_refptr<RaycastHit>> World::RaycastBatch(epointer rays,
+                                                      uint32_t count,
+                                                      double max_distance,
+                                                      uint64_t layer_mask,
+                                                      URGE_EXCEPTION) {
+  if (!rays) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR, "invalid ray buffer.");
+    return {};
+  }
+
+  UpdateSpatialIndex();
+
+  earray<scoped_refptr<RaycastHit>> hits(count);
+  const double* packed = static_cast<const double*>(rays);
+  for (uint32_t i = 0; i < count; ++i, packed += kPackedRaySize) {
+    const glm::dvec3 origin(packed[0], packed[1], packed[2]);
+    const glm::dvec3 direction(packed[3], packed[4], packed[5]);
+    if (glm::length(direction) > 0.0)
+      hits[i] = RaycastClosest(origin, glm::normalize(direction), max_distance,
+                               layer_mask);
+  }
+
+  return hits;
+}
+
+earray<scoped_refptr<MeshRenderer>> World::OverlapBox(
+    scoped_refptr<Vector3d> center,
+    scoped_refptr<Vector3d> half_extents,
+    uint64_t layer_mask,
+    URGE_EXCEPTION) {
+  if (!center || !half_extents) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR, "invalid box.");
+    return {};
+  }
+
+  UpdateSpatialIndex();
+
+  const glm::dvec3 extents = glm::abs(half_extents->data());
+  const AABB box(glm::vec3(center->data() - extents),
+                 glm::vec3(center->data() + extents));
+
+  earray<scoped_refptr<MeshRenderer>> results;
+  renderer_tree_.Query(box, [&](uint32_t handle) {
+    const RendererEntry& entry = renderers_[handle];
+    if (!(entry.layer & layer_mask) ||
+        (entry.flags & RendererEntry::kStaticBatch))
+      return;
+
+    const AABB bounds = ComputeWorldBounds(
+        entry, transform_hierarchy_.world_matrix(entry.transform));
+    if (glm::all(glm::lessThanEqual(bounds.min, box.max)) &&
+        glm::all(glm::greaterThanEqual(bounds.max, box.min)))
+      results.push_back(entry.renderer);
+  });
+
+  return results;
+}
+
+earray<scoped_refptr<MeshRenderer>> World::OverlapSphere(
+    scoped_refptr<Vector3d> center,
+    double radius,
+    uint64_t layer_mask,
+    URGE_EXCEPTION) {
+  if (!center) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR, "invalid sphere.");
+    return {};
+  }
+
+  UpdateSpatialIndex();
+
+  const glm::dvec3& sphere_center = center->data();
+  const AABB box(glm::vec3(sphere_center - radius),
+                 glm::vec3(sphere_center + radius));
+
+  earray<scoped_refptr<MeshRenderer>> results;
+  renderer_tree_.Query(box, [&](uint32_t handle) {
+    const RendererEntry& entry = renderers_[handle];
+    if (!(entry.layer & layer_mask) ||
+        (entry.flags & RendererEntry::kStaticBatch))
+      return;
+
+    // Distance from center to the closest point of bounds
+    const AABB bounds = ComputeWorldBounds(
+        entry, transform_hierarchy_.world_matrix(entry.transform));
+    const glm::dvec3 closest = glm::clamp(
+        sphere_center, glm::dvec3(bounds.min), glm::dvec3(bounds.max));
+    const glm::dvec3 offset = closest - sphere_center;
+    if (glm::dot(offset, offset) <= radius * radius)
+      results.push_back(entry.renderer);
+  });
+
+  return results;
+}
+
+void World::BuildStaticBatches(URGE_EXCEPTION) {
+  ClearStaticBatches(exception_state);
+
+  // Static matrices are frozen on this update
+  UpdateTransforms();
+
+  // Sources sharing vertex layout and layer, in registration order
+  using BatchKey = std::tuple<uint32_t, uint32_t, bool, uint32_t, uint32_t>;
+  std::map<BatchKey, std::vector<MeshRenderer*>> groups;
+  for (const auto& entry : renderers_) {
+    MeshRenderer* renderer = entry.renderer;
+    Mesh* mesh = renderer->mesh();
+    if (!renderer->is_static() || renderer->lod_group() ||
+        (entry.flags & RendererEntry::kStaticBatch))
+      continue;
+    if (!mesh || !mesh->has_layout() || mesh->mesh_group().empty())
+      continue;
+
+    // Every submesh needs a material to be drawn from the batch
+    bool complete = true;
+    for (const auto& submesh : mesh->mesh_group())
+      complete &= submesh->materialSlot < renderer->materials().size() &&
+                  renderer->materials()[submesh->materialSlot];
+    if (!complete)
+      continue;
+
+    const BatchKey key(mesh->vertex_stride(), mesh->position_offset(),
+                       mesh->has_normal(),
+                       mesh->has_normal() ? mesh->normal_offset() : 0,
+                       renderer->layer());
+    groups[key].push_back(renderer);
+  }
+
+  for (const auto& group : groups)
+    if (group.second.size() > 1)
+      BuildStaticBatch(group.second);
+}
+
+void World::ClearStaticBatches(URGE_EXCEPTION) {
+  while (!static_batches_.empty())
+    ReleaseStaticBatch(static_batches_.handle_at(0));
+}
+
+void World::UpdateTransforms() {
+  transform_hierarchy_.Update(base::WorkerPool::GetDefault());
+  UpdateSpatialIndex();
+}
+
+void World::UpdateSpatialIndex() {
+  transform_hierarchy_.Update();
+
+  // Registered or resized renderers
+  for (RendererHandle handle : spatial_pending_)
+    if (renderers_.Contains(handle))
+      RefitRenderer(handle);
+  spatial_pending_.clear();
+
+  // Renderers whose transforms were recomputed
+  if (transform_hierarchy_.all_changed()) {
+    for (size_t i = 0; i < renderers_.size(); ++i)
+      RefitRenderer(renderers_.handle_at(i));
+  } else {
+    for (const auto& range : transform_hierarchy_.changed_ranges()) {
+      for (uint32_t index = range.first; index < range.second; ++index) {
+        const auto transform = transform_hierarchy_.handle_at(index);
+        if (transform < transform_renderers_.size() &&
+            transform_renderers_[transform] != kInvalidRendererHandle)
+          RefitRenderer(transform_renderers_[transform]);
+      }
+    }
+  }
+
+  transform_hierarchy_.ClearChanges();
 }
 
-void World::UnregisterCamera(Camera* camera) {
-  auto it = std::find(cameras_.begin(), cameras_.end(), camera);
-  if (it != cameras_.end())
-    cameras_.erase(it);
+void World::RefitRenderer(RendererHandle handle) {
+  RendererEntry& entry = renderers_[handle];
+  const uint32_t generation =
+      transform_hierarchy_.GetGeneration(entry.transform);
+  if (entry.generation == generation)
+    return;
+
+  entry.generation = generation;
+  const AABB bounds = ComputeWorldBounds(
+      entry, transform_hierarchy_.world_matrix(entry.transform));
+  if (entry.proxy == BoundingVolumeTree::kNullProxy)
+    entry.proxy = renderer_tree_.CreateProxy(bounds, handle);
+  else
+    renderer_tree_.MoveProxy(entry.proxy, bounds);
 }
 
-void World::RegisterRenderer(MeshRenderer* renderer) {
-  renderers_.push_back(renderer);
+scoped_refptr<RaycastHit> World::RaycastClosest(const glm::dvec3& origin,
+                                                const glm::dvec3& direction,
+                                                double max_distance,
+                                                uint64_t layer_mask) {
+  const RendererEntry* hit_entry = nullptr;
+  double hit_distance = max_distance;
+
+  renderer_tree_.RayCast(
+      glm::vec3(origin), glm::vec3(direction),
+      static_cast<float>(max_distance),
+      [&](uint32_t handle, float clip_distance) {
+        const RendererEntry& entry = renderers_[handle];
+        if (!(entry.layer & layer_mask) ||
+            (entry.flags & RendererEntry::kStaticBatch))
+          return clip_distance;
+
+        // Oriented bounds test in local space, affine transforms keep the
+        // ray parameter so distances stay in world units.
+        const glm::dmat4x4 inverse = glm::affineInverse(
+            transform_hierarchy_.world_matrix(entry.transform));
+        const glm::dvec3 local_origin(inverse * glm::dvec4(origin, 1.0));
+        const glm::dvec3 local_direction(inverse * glm::dvec4(direction, 0.0));
+
+        double t_min = 0.0, t_max = hit_distance;
+        if (!ClipRayToBox(local_origin, local_direction,
+                          glm::dvec3(entry.bounds_min),
+                          glm::dvec3(entry.bounds_max), t_min, t_max))
+          return clip_distance;
+
+        hit_entry = &entry;
+        hit_distance = t_min;
+        return static_cast<float>(t_min);
+      });
+
+  if (!hit_entry)
+    return nullptr;
+
+  auto hit = Object::Create<RaycastHit>();
+  hit->renderer = hit_entry->renderer;
+  hit->distance = hit_distance;
+  hit->point = Object::Create<Vector3d>(origin + direction * hit_distance);
+  return hit;
 }
 
-void World::UnregisterRenderer(MeshRenderer* renderer) {
-  auto it = std::find(renderers_.begin(), renderers_.end(), renderer);
-  if (it != renderers_.end())
-    renderers_.erase(it);
+void World::BuildStaticBatch(const std::vector<MeshRenderer*>& sources) {
+  Mesh* layout = sources.front()->mesh();
+  const uint32_t stride = layout->vertex_stride();
+  const uint32_t position_offset = layout->position_offset();
+  const bool has_normal = layout->has_normal();
+  const uint32_t normal_offset = layout->normal_offset();
+
+  // Batch origin at the center of all sources keeps baked positions small
+  glm::dvec3 bounds_min(std::numeric_limits<double>::max());
+  glm::dvec3 bounds_max(std::numeric_limits<double>::lowest());
+  for (auto* source : sources) {
+    const auto& entry = renderers_[source->registry_handle()];
+    const AABB bounds = ComputeWorldBounds(
+        entry, transform_hierarchy_.world_matrix(entry.transform));
+    bounds_min = glm::min(bounds_min, glm::dvec3(bounds.min));
+    bounds_max = glm::max(bounds_max, glm::dvec3(bounds.max));
+  }
+  const glm::dvec3 origin = (bounds_min + bounds_max) * 0.5;
+
+  // Combined vertices in batch space, indices grouped by material
+  std::vector<uint8_t> vertices;
+  std::vector<scoped_refptr<Material>> materials;
+  std::vector<std::vector<uint32_t>> material_indices;
+  for (auto* source : sources) {
+    Mesh* mesh = source->mesh();
+    const size_t vertex_count = mesh->vertices().size() / stride;
+    const uint32_t base_vertex =
+        static_cast<uint32_t>(vertices.size() / stride);
+    vertices.insert(vertices.end(), mesh->vertices().begin(),
+                    mesh->vertices().begin() + vertex_count * stride);
+
+    glm::dmat4x4 relative = transform_hierarchy_.world_matrix(
+        renderers_[source->registry_handle()].transform);
+    relative[3] -= glm::dvec4(origin, 0.0);
+    const glm::mat4 position_matrix(relative);
+    const glm::mat3 normal_matrix =
+        glm::inverseTranspose(glm::mat3(position_matrix));
+
+    uint8_t* vertex = vertices.data() + base_vertex * stride;
+    for (size_t i = 0; i < vertex_count; ++i, vertex += stride) {
+      glm::vec3 position;
+      std::memcpy(&position, vertex + position_offset, sizeof(position));
+      position = glm::vec3(position_matrix * glm::vec4(position, 1.0f));
+      std::memcpy(vertex + position_offset, &position, sizeof(position));
+
+      if (has_normal) {
+        glm::vec3 normal;
+        std::memcpy(&normal, vertex + normal_offset, sizeof(normal));
+        normal = glm::normalize(normal_matrix * normal);
+        std::memcpy(vertex + normal_offset, &normal, sizeof(normal));
+      }
+    }
+
+    // Submesh indices are relative to their vertex start
+    const auto& source_indices = mesh->indices();
+    for (const auto& submesh : mesh->mesh_group()) {
+      const auto& material = source->materials()[submesh->materialSlot];
+      auto it = std::find(materials.begin(), materials.end(), material);
+      const size_t slot = std::distance(materials.begin(), it);
+      if (it == materials.end()) {
+        materials.push_back(material);
+        material_indices.emplace_back();
+      }
+
+      const size_t index_end =
+          std::min<size_t>(submesh->indexStart + submesh->indexCount,
+                           source_indices.size());
+      for (size_t i = submesh->indexStart; i < index_end; ++i)
+        material_indices[slot].push_back(base_vertex + submesh->vertexStart +
+                                         source_indices[i]);
+    }
+  }
+
+  size_t index_count = 0;
+  for (const auto& indices : material_indices)
+    index_count += indices.size();
+
+  // Combined mesh, one submesh per material
+  ExceptionState exception_state;
+  auto mesh = Object::Create<Mesh>(0, static_cast<uint32_t>(index_count));
+  mesh->vertices() = std::move(vertices);
+  mesh->Put_Layout(layout->Get_Layout(exception_state), exception_state);
+
+  const uint32_t total_vertices =
+      static_cast<uint32_t>(mesh->vertices().size() / stride);
+  std::vector<scoped_refptr<SubMesh>> submeshes;
+  uint32_t index_start = 0;
+  for (size_t slot = 0; slot < materials.size(); ++slot) {
+    const auto& indices = material_indices[slot];
+    std::copy(indices.begin(), indices.end(),
+              mesh->indices().begin() + index_start);
+
+    glm::vec3 submesh_min(std::numeric_limits<float>::max());
+    glm::vec3 submesh_max(std::numeric_limits<float>::lowest());
+    for (auto index : indices) {
+      glm::vec3 position;
+      std::memcpy(&position,
+                  mesh->vertices().data() + index * stride + position_offset,
+                  sizeof(position));
+      submesh_min = glm::min(submesh_min, position);
+      submesh_max = glm::max(submesh_max, position);
+    }
+
+    auto submesh = Object::Create<SubMesh>();
+    submesh->materialSlot = static_cast<uint32_t>(slot);
+    submesh->indexStart = index_start;
+    submesh->indexCount = static_cast<uint32_t>(indices.size());
+    submesh->vertexStart = 0;
+    submesh->vertexCount = total_vertices;
+    if (!indices.empty()) {
+      submesh->boundsMin = Object::Create<Vector3>(submesh_min);
+      submesh->boundsMax = Object::Create<Vector3>(submesh_max);
+    }
+    submeshes.push_back(submesh);
+
+    index_start += submesh->indexCount;
+  }
+  mesh->SetupSubMeshData(std::move(submeshes), exception_state);
+  mesh->MarkVerticesChanged();
+  mesh->MarkIndicesChanged();
+
+  // Combined renderer placed at batch origin
+  base::ObjectPoolScope pool_scope(object_pools_.get());
+  auto renderer = Object::Create<MeshRenderer>();
+  renderer->Put_Mesh(mesh, exception_state);
+  for (size_t slot = 0; slot < materials.size(); ++slot)
+    renderer->SetMaterialAtSlot(static_cast<uint32_t>(slot), materials[slot],
+                                exception_state);
+  renderer->Put_Layer(sources.front()->layer(), exception_state);
+  renderer->Put_Static(true, exception_state);
+  renderer->transform()->SetData(origin, glm::dquat(1.0, 0.0, 0.0, 0.0),
+                                 glm::dvec3(1.0));
+  renderer->ComputeAABB(exception_state);
+  renderer->Put_Parent(static_batch_root_, exception_state);
+
+  renderers_[renderer->registry_handle()].flags |= RendererEntry::kStaticBatch;
+
+  StaticBatch batch;
+  batch.renderer = renderer;
+  batch.sources = sources;
+  const StaticBatchHandle handle = static_batches_.Insert(std::move(batch));
+
+  for (auto* source : sources) {
+    renderers_[source->registry_handle()].flags |= RendererEntry::kBatched;
+    source->set_static_batch(handle);
+  }
+}
+
+void World::ReleaseStaticBatch(StaticBatchHandle handle) {
+  StaticBatch batch = std::move(static_batches_[handle]);
+  static_batches_.Remove(handle);
+
+  for (auto* source : batch.sources) {
+    source->set_static_batch(kInvalidStaticBatchHandle);
+    if (source->registry_handle() != kInvalidRendererHandle)
+      renderers_[source->registry_handle()].flags &= ~RendererEntry::kBatched;
+  }
+  ++registry_serial_;
+
+  batch.renderer->SetupWorld(nullptr, this);
+  batch.renderer->ResetParent(nullptr);
+}
+
+void World::IndexNode(Node* node) {
+  if (node->name_.empty())
+    return;
+
+  auto& names = name_index_[node->name_];
+  node->name_index_slot_ = static_cast<uint32_t>(names.size());
+  names.push_back(node);
+
+  auto& siblings = child_index_[ChildKey{node->parent_, node->name_}];
+  node->child_index_slot_ = static_cast<uint32_t>(siblings.size());
+  siblings.push_back(node);
+}
+
+void World::UnindexNode(Node* node) {
+  if (node->name_.empty())
+    return;
+
+  // Swap-remove from both buckets
+  auto names = name_index_.find(node->name_);
+  auto& name_bucket = names->second;
+  name_bucket[node->name_index_slot_] = name_bucket.back();
+  name_bucket[node->name_index_slot_]->name_index_slot_ =
+      node->name_index_slot_;
+  name_bucket.pop_back();
+  if (name_bucket.empty())
+    name_index_.erase(names);
+
+  auto siblings = child_index_.find(ChildKey{node->parent_, node->name_});
+  auto& sibling_bucket = siblings->second;
+  sibling_bucket[node->child_index_slot_] = sibling_bucket.back();
+  sibling_bucket[node->child_index_slot_]->child_index_slot_ =
+      node->child_index_slot_;
+  sibling_bucket.pop_back();
+  if (sibling_bucket.empty())
+    child_index_.erase(siblings);
+}
+
+Node* World::FindChildByName(Node* parent, const std::string& name) {
+  auto it = child_index_.find(ChildKey{parent, name});
+  return it != child_index_.end() ? it->second.front() : nullptr;
+}
+
+World::CameraHandle World::RegisterCamera(Camera* camera) {
+  return cameras_.Insert(camera);
+}
+
+void World::UnregisterCamera(CameraHandle handle) {
+  cameras_.Remove(handle);
+}
+
+void World::ReserveNodes(size_t node_count, size_t renderer_count) {
+  transform_hierarchy_.Reserve(node_count);
+  renderers_.Reserve(renderer_count);
+}
+
+World::RendererHandle World::RegisterRenderer(MeshRenderer* renderer) {
+  RendererEntry entry;
+  entry.renderer = renderer;
+  entry.transform = renderer->transform_handle();
+  entry.layer = renderer->layer();
+  entry.flags = renderer->is_occluder() ? RendererEntry::kOccluder : 0;
+  entry.lod_group = renderer->lod_group();
+  entry.bounds_min = renderer->bounds_min_data();
+  entry.bounds_max = renderer->bounds_max_data();
+  entry.proxy = BoundingVolumeTree::kNullProxy;
+  entry.generation = kStaleGeneration;
+
+  const RendererHandle handle = renderers_.Insert(entry);
+  if (entry.transform >= transform_renderers_.size())
+    transform_renderers_.resize(entry.transform + 1, kInvalidRendererHandle);
+  transform_renderers_[entry.transform] = handle;
+  spatial_pending_.push_back(handle);
+
+  ++registry_serial_;
+  return handle;
+}
+
+void World::UnregisterRenderer(RendererHandle handle) {
+  // Batch can not outlive its sources
+  const StaticBatchHandle batch = renderers_[handle].renderer->static_batch();
+  if (batch != kInvalidStaticBatchHandle)
+    ReleaseStaticBatch(batch);
+
+  const auto& entry = renderers_[handle];
+  if (entry.proxy != BoundingVolumeTree::kNullProxy)
+    renderer_tree_.DestroyProxy(entry.proxy);
+  transform_renderers_[entry.transform] = kInvalidRendererHandle;
+
+  renderers_.Remove(handle);
+  ++registry_serial_;
+}
+
+void World::RefreshRenderer(RendererHandle handle) {
+  auto& entry = renderers_[handle];
+  if (entry.layer != entry.renderer->layer() ||
+      entry.lod_group != entry.renderer->lod_group()) {
+    entry.layer = entry.renderer->layer();
+    entry.lod_group = entry.renderer->lod_group();
+    ++registry_serial_;
+  }
+
+  if (!!(entry.flags & RendererEntry::kOccluder) !=
+      entry.renderer->is_occluder()) {
+    entry.flags ^= RendererEntry::kOccluder;
+    ++registry_serial_;
+  }
+
+  const glm::vec3& bounds_min = entry.renderer->bounds_min_data();
+  const glm::vec3& bounds_max = entry.renderer->bounds_max_data();
+  if (entry.bounds_min != bounds_min || entry.bounds_max != bounds_max) {
+    entry.bounds_min = bounds_min;
+    entry.bounds_max = bounds_max;
+    entry.generation = kStaleGeneration;
+    spatial_pending_.push_back(handle);
+    ++registry_serial_;
+  }
+}
+
+bool World::CheckTransformAccess(const earray<scoped_refptr<Node>>& nodes,
+                                 epointer data,
+                                 uint32_t count,
+                                 URGE_EXCEPTION) {
+  if (!data) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                          "invalid transform buffer.");
+    return false;
+  }
+
+  if (count != nodes.size()) {
+    exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                          "invalid transform count: {}, expected {}.", count,
+                          nodes.size());
+    return false;
+  }
+
+  // Validate every node before touching the hierarchy
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (!nodes[i]) {
+      exception_state.Throw(ExceptionCode::CONTENT_ERROR, "invalid node: {}",
+                            i);
+      return false;
+    }
+
+    if (nodes[i]->world() != this) {
+      exception_state.Throw(ExceptionCode::CONTENT_ERROR,
+                            "node outside of world: {}", i);
+      return false;
+    }
+  }
+
+  return true;
 }
 
 }  // namespace content
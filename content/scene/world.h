@@ -5,31 +5,108 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "base/memory/object_pool.h"
 #include "base/memory/ref_counted.h"
+#include "base/template/slot_map.h"
 #include "content/content_config.h"
+#include "content/scene/bounding_volume_tree.h"
 #include "content/scene/node.h"
+#include "content/scene/transform_hierarchy.h"
 
 namespace content {
 
 class Camera;
+class LODGroup;
 class MeshRenderer;
+class RaycastHit;
 class Viewport;
 
+// Packed per-renderer data streamed by culling
+struct RendererEntry {
+  // Drawn through a static batch instead
+  static constexpr uint32_t kBatched = 1 << 0;
+  // Combined renderer owned by a static batch
+  static constexpr uint32_t kStaticBatch = 1 << 1;
+  // Rasterized into occlusion buffers
+  static constexpr uint32_t kOccluder = 1 << 2;
+
+  MeshRenderer* renderer;
+  TransformHierarchy::Handle transform;
+  uint32_t layer;
+  uint32_t flags;
+  LODGroup* lod_group;
+  glm::vec3 bounds_min;
+  glm::vec3 bounds_max;
+
+  // Spatial index proxy and transform generation it was built from
+  BoundingVolumeTree::ProxyId proxy;
+  uint32_t generation;
+};
+
+// Static renderers sharing vertex layout and layer merged into one mesh
+struct StaticBatch {
+  scoped_refptr<MeshRenderer> renderer;
+  std::vector<MeshRenderer*> sources;
+};
+
 URGE_BINDING()
 class World : public Object {
  public:
   World();
+  ~World() override;
 
   World(const World&) = delete;
   World& operator=(const World&) = delete;
 
-  void RegisterCamera(Camera* camera);
-  void UnregisterCamera(Camera* camera);
+  TransformHierarchy* transform_hierarchy() { return &transform_hierarchy_; }
+
+  // Allocation pools of scene objects created for this world, see
+  // base::ObjectPoolScope.
+  base::ObjectPoolSet* object_pools() { return object_pools_.get(); }
+
+  // Transform stage: resolve world matrices of all nodes before rendering.
+  void UpdateTransforms();
+
+  // Refits the renderer tree for renderers moved since the last call.
+  void UpdateSpatialIndex();
+  const BoundingVolumeTree& renderer_tree() const { return renderer_tree_; }
+
+  using CameraHandle = base::SlotMap<Camera*>::Handle;
+  using RendererHandle = base::SlotMap<RendererEntry>::Handle;
+  using StaticBatchHandle = base::SlotMap<StaticBatch>::Handle;
+  static constexpr CameraHandle kInvalidCameraHandle =
+      base::SlotMap<Camera*>::kInvalidHandle;
+  static constexpr RendererHandle kInvalidRendererHandle =
+      base::SlotMap<RendererEntry>::kInvalidHandle;
+  static constexpr StaticBatchHandle kInvalidStaticBatchHandle =
+      base::SlotMap<StaticBatch>::kInvalidHandle;
+
+  CameraHandle RegisterCamera(Camera* camera);
+  void UnregisterCamera(CameraHandle handle);
+
+  RendererHandle RegisterRenderer(MeshRenderer* renderer);
+  void UnregisterRenderer(RendererHandle handle);
+  // Pulls layer, lod group, occluder flag and local bounds of a registered
+  // renderer.
+  void RefreshRenderer(RendererHandle handle);
 
-  void RegisterRenderer(MeshRenderer* renderer);
-  void UnregisterRenderer(MeshRenderer* renderer);
+  // Serial of renderer registration, layer, lod group, occluder, bounds and
+  // batching changes.
+  uint32_t registry_serial() const { return registry_serial_; }
+
+  // Preallocates component storage ahead of attaching a batch of nodes.
+  void ReserveNodes(size_t node_count, size_t renderer_count);
+
+  // Name index, unnamed nodes are not indexed.
+  void IndexNode(Node* node);
+  void UnindexNode(Node* node);
+  Node* FindChildByName(Node* parent, const std::string& name);
+
+  // Restores the sources of a batch to be drawn individually.
+  void ReleaseStaticBatch(StaticBatchHandle handle);
 
  public:
   URGE_BINDING()
@@ -38,15 +115,138 @@ class World : public Object {
   URGE_BINDING()
   URGE_ATTRIBUTE_DECLARE(Root, scoped_refptr<Node>);
 
+  // Any node in world with |name|, null if none.
+  URGE_BINDING()
+  scoped_refptr<Node> FindByName(estring name, URGE_EXCEPTION);
+
+  // Objects allocated from the pools of this world instead of the general
+  // heap, for nodes that will be attached to it and values kept with them.
+  URGE_BINDING()
+  scoped_refptr<Node> CreateNode(URGE_EXCEPTION);
+
+  URGE_BINDING()
+  scoped_refptr<MeshRenderer> CreateMeshRenderer(URGE_EXCEPTION);
+
+  URGE_BINDING()
+  scoped_refptr<Vector3d> CreateVector3d(double x,
+                                         double y,
+                                         double z,
+                                         URGE_EXCEPTION);
+
+  // Packed transform layout of bulk access, 10 doubles per node:
+  //   position (x, y, z), quaternion (x, y, z, w), scale (x, y, z)
+  // |data| holds |count| packed transforms, which must match the node count.
+  // All nodes must belong to this world.
+  URGE_BINDING()
+  void WriteTransforms(earray<scoped_refptr<Node>> nodes,
+                       epointer data,
+                       uint32_t count,
+                       URGE_EXCEPTION);
+
+  URGE_BINDING()
+  void ReadTransforms(earray<scoped_refptr<Node>> nodes,
+                      epointer data,
+                      uint32_t count,
+                      URGE_EXCEPTION);
+
+  // Spatial queries test renderer bounds with layers in |layer_mask|, rays
+  // are tested against the oriented local bounds.
+  URGE_BINDING()
+  scoped_refptr<RaycastHit> Raycast(scoped_refptr<Vector3d> origin,
+                                    scoped_refptr<Vector3d> direction,
+                                    double max_distance,
+                                    uint64_t layer_mask,
+                                    URGE_EXCEPTION);
+
+  // Packed ray layout, 6 doubles per ray:
+  //   origin (x, y, z), direction (x, y, z)
+  // Returns the closest hit of each ray, null for misses.
+  URGE_BINDING()
+  earray<scoped_refptr<RaycastHit>> RaycastBatch(epointer rays,
+                                                 uint32_t count,
+                                                 double max_distance,
+                                                 uint64_t layer_mask,
+                                                 URGE_EXCEPTION);
+
+  URGE_BINDING()
+  earray<scoped_refptr<MeshRenderer>> OverlapBox(
+      scoped_refptr<Vector3d> center,
+      scoped_refptr<Vector3d> half_extents,
+      uint64_t layer_mask,
+      URGE_EXCEPTION);
+
+  URGE_BINDING()
+  earray<scoped_refptr<MeshRenderer>> OverlapSphere(
+      scoped_refptr<Vector3d> center,
+      double radius,
+      uint64_t layer_mask,
+      URGE_EXCEPTION);
+
+  // Merges static renderers with a declared vertex layout into combined
+  // meshes baked to a shared origin, one submesh per material. Batches are
+  // released when a source stops being static or changes mesh, material or
+  // layer; edits of vertex data require a rebuild.
+  URGE_BINDING()
+  void BuildStaticBatches(URGE_EXCEPTION);
+
+  URGE_BINDING()
+  void ClearStaticBatches(URGE_EXCEPTION);
+
  private:
   friend class Viewport;
   friend class RenderContext;
 
+  scoped_refptr<RaycastHit> RaycastClosest(const glm::dvec3& origin,
+                                           const glm::dvec3& direction,
+                                           double max_distance,
+                                           uint64_t layer_mask);
+  void BuildStaticBatch(const std::vector<MeshRenderer*>& sources);
+  void RefitRenderer(RendererHandle handle);
+  bool CheckTransformAccess(const earray<scoped_refptr<Node>>& nodes,
+                            epointer data,
+                            uint32_t count,
+                            URGE_EXCEPTION);
+
+  scoped_refptr<base::ObjectPoolSet> object_pools_;
   scoped_refptr<Node> root_;
 
+  // Nodes by name and by (parent, name), buckets hold repeated names
+  struct ChildKey {
+    const Node* parent;
+    std::string name;
+
+    bool operator==(const ChildKey& other) const {
+      return parent == other.parent && name == other.name;
+    }
+  };
+
+  struct ChildKeyHash {
+    size_t operator()(const ChildKey& key) const {
+      return std::hash<std::string>()(key.name) ^
+             (std::hash<const void*>()(key.parent) << 1);
+    }
+  };
+
+  std::unordered_map<std::string, std::vector<Node*>> name_index_;
+  std::unordered_map<ChildKey, std::vector<Node*>, ChildKeyHash> child_index_;
+
+  // Flattened transform storage of all nodes in world
+  TransformHierarchy transform_hierarchy_;
+
   // Scene components storage
-  std::vector<MeshRenderer*> renderers_;
-  std::vector<Camera*> cameras_;
+  base::SlotMap<RendererEntry> renderers_;
+  base::SlotMap<Camera*> cameras_;
+
+  // Combined static renderers, parented to a node outside of root tree
+  base::SlotMap<StaticBatch> static_batches_;
+  scoped_refptr<Node> static_batch_root_;
+
+  // World space bounds of renderers, synced after transform updates. Only
+  // renderers on recomputed transforms and pending renderers are refit.
+  BoundingVolumeTree renderer_tree_;
+  std::vector<RendererHandle> transform_renderers_;
+  std::vector<RendererHandle> spatial_pending_;
+  uint32_t registry_serial_;
 };
 
 }  // namespace content
@@ -95,7 +95,16 @@ std::unique_ptr<RenderDevice> RenderDevice::Create(
       *device_out = wgpu::Device::Acquire(device);
     };
 
-    adapter.RequestDevice(nullptr, device_callback);
+    // Immediate data carries per-draw constants, request all the adapter
+    // supports instead of the default of none
+    wgpu::Limits supported_limits;
+    adapter.GetLimits(&supported_limits);
+    wgpu::Limits required_limits;
+    required_limits.maxImmediateSize = supported_limits.maxImmediateSize;
+
+    wgpu::DeviceDescriptor device_desc;
+    device_desc.requiredLimits = &required_limits;
+    adapter.RequestDevice(&device_desc, device_callback);
   }
 
   // Queue